@@ -263,6 +263,9 @@ GLbyte Block::GetSharedAttribute(BLOCKATTRIBUTE _attribute) const {
         case BLOCKATTRIBUTE::TRANSPARENT:
             return transparent;
 
+        case BLOCKATTRIBUTE::OBSCURES_SELF:
+            return obscuresSelf;
+
         case BLOCKATTRIBUTE::LIQUID:
             return liquid;
 
@@ -297,17 +300,35 @@ GLbyte Block::GetSharedAttribute(BLOCKATTRIBUTE _attribute) const {
 
 
 
+/*
+ * Hashes a world block position, so that "random" attributes are always the same for a given position and do not
+ * need to be stored.
+ */
+
+static unsigned int HashBlockPosition(const glm::vec3& _blockPosition) {
+    auto x = (unsigned int)(int)std::floor(_blockPosition.x);
+    auto y = (unsigned int)(int)std::floor(_blockPosition.y);
+    auto z = (unsigned int)(int)std::floor(_blockPosition.z);
+
+    unsigned int hash = (x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u);
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    return hash ^ (hash >> 15);
+}
+
+
+
 /*
  * Returns a value which is a permitted direction for the top face of the block to be pointing in. Should the block be
- * locked to pointing up, then it will only return the UP direction. Else a random direction will be chosen.
+ * locked to pointing up, then it will only return the UP direction. Else a direction will be chosen from the position.
  */
 
-DIRECTION Block::GetRandomTopFaceDirection() const {
+DIRECTION Block::GetRandomTopFaceDirection(const glm::vec3& _blockPosition) const {
     if (topFaceLocked) return UP;
 
     // random dir from:
     std::array<DIRECTION, 6> directions {UP, DOWN, NORTH, SOUTH, EAST, WEST};
-    return directions[rand() % 6 + 0];
+    return directions[(HashBlockPosition(_blockPosition) >> 8) % 6];
 }
 
 /*
@@ -316,9 +337,9 @@ DIRECTION Block::GetRandomTopFaceDirection() const {
  * may require converting to radians for glm functions.
  */
 
-GLbyte Block::GetRandomRotation() const {
+GLbyte Block::GetRandomRotation(const glm::vec3& _blockPosition) const {
     if (rotationLocked) return 0;
-    return GLbyte((rand() % 4 + 0) * 2);
+    return GLbyte((HashBlockPosition(_blockPosition) % 4) * 2);
 }
 
 
@@ -333,6 +354,21 @@ glm::i8vec3 Block::GetRandomSubOffset(const glm::vec3& _blockPosition) const {
 }
 
 
+
+/*
+ * The attributes given to the block when it is generated at the given world position
+ */
+
+BlockAttributes Block::GetGeneratedAttributes(const glm::vec3& _blockPosition) const {
+    BlockAttributes attributes;
+    attributes.halfRightRotations = GetRandomRotation(_blockPosition);
+    attributes.topFaceDirection = GetRandomTopFaceDirection(_blockPosition);
+    attributes.subBlockOffset = GetRandomSubOffset(_blockPosition);
+
+    return attributes;
+}
+
+
 std::vector<UniqueVertex> Block::GetFaceVerticies(const std::vector<BLOCKFACE> &_faces, const BlockAttributes& _blockAttributes) const {
     if (blockModel == EMPTY) return {}; // catch air blocks
 
@@ -148,7 +148,8 @@ enum class BLOCKATTRIBUTE {
 /*
  * Data struct to contain block attributes which are not equivalent within all instances of a block type. Whilst all
  * grass blocks are solid (hence the attribute is stored in the block object), they may face in a different direction,
- * and thus this is stored in BlockAttributes.
+ * and thus this is stored in BlockAttributes. Chunks only store the attributes of blocks which differ from a default
+ * constructed BlockAttributes.
  */
 
 struct BlockAttributes {
@@ -159,6 +160,15 @@ struct BlockAttributes {
     glm::i8vec3 subBlockOffset {0,0,0};
 
     [[nodiscard]] GLbyte GetIndividualAttribute(BLOCKATTRIBUTE _attribute) const;
+
+    friend bool operator==(const BlockAttributes& A, const BlockAttributes& B) {
+        return A.halfRightRotations == B.halfRightRotations && A.topFaceDirection == B.topFaceDirection &&
+               A.blockLight == B.blockLight && A.skyLight == B.skyLight && A.subBlockOffset == B.subBlockOffset;
+    }
+
+    friend bool operator!=(const BlockAttributes& A, const BlockAttributes& B) {
+        return !(A == B);
+    }
 };
 
 
@@ -209,9 +219,10 @@ class Block {
         [[nodiscard]] GLbyte GetSharedAttribute(BLOCKATTRIBUTE _attribute) const;
 
         // Unique Block Attributes
-        [[nodiscard]] DIRECTION GetRandomTopFaceDirection() const;
-        [[nodiscard]] GLbyte GetRandomRotation() const;
+        [[nodiscard]] DIRECTION GetRandomTopFaceDirection(const glm::vec3& _blockPosition) const;
+        [[nodiscard]] GLbyte GetRandomRotation(const glm::vec3& _blockPosition) const;
         [[nodiscard]] glm::i8vec3 GetRandomSubOffset(const glm::vec3& _blockPosition) const;
+        [[nodiscard]] BlockAttributes GetGeneratedAttributes(const glm::vec3& _blockPosition) const;
 
         // Block Face Culling
         [[nodiscard]] std::vector<UniqueVertex> GetFaceVerticies(const std::vector<BLOCKFACE>& _faces, const BlockAttributes& _blockAttributes) const;
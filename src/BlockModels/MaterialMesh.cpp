@@ -4,7 +4,7 @@
 
 #include "MaterialMesh.h"
 
-MaterialMesh::MaterialMesh(Block* _block) {
+MaterialMesh::MaterialMesh(const Block* _block) {
     glGenVertexArrays(1, &vertexArrayObject);
     glGenBuffers(1, &vertexBufferObject);
     glGenBuffers(1, &indexBufferObject);
@@ -18,25 +18,61 @@ MaterialMesh::~MaterialMesh() {
     glDeleteVertexArrays(1, &vertexArrayObject);
 }
 
-void MaterialMesh::AddVerticies(const std::vector<UniqueVertex>& _verticies, const glm::vec3& _position) {
-    if (_verticies.empty()) return;
-
+void MaterialMesh::AddVerticies(std::vector<UniqueVertex>* _sectionVerticies,
+                                const std::vector<UniqueVertex>& _verticies, const glm::vec3& _position) {
     for (const UniqueVertex& vertex : _verticies) {
-        vertexArray.push_back(vertex);
-        vertexArray.back().worldPosition = _position;
+        _sectionVerticies->push_back(vertex);
+        _sectionVerticies->back().worldPosition = _position;
     }
+}
 
+void MaterialMesh::SetSectionVerticies(int _section, std::vector<UniqueVertex>&& _verticies) {
+    std::unique_lock lock(verticiesMutex);
+    sectionVerticies[_section].swap(_verticies);
     oldMesh = true;
     readyToBind = false;
 }
 
 void MaterialMesh::ResetVerticies() {
-    vertexArray.clear();
+    std::unique_lock lock(verticiesMutex);
+    for (auto& verticies : sectionVerticies) verticies.clear();
+    combinedVerticies.clear();
     oldMesh = true;
     readyToBind = false;
 }
 
+/*
+ * Combines the section verticies into the verticies to be bound, and marks the mesh as ready to bind. Called by the
+ * meshing thread after replacing the mesh's sections.
+ */
+
+void MaterialMesh::CombineSectionVerticies() {
+    std::unique_lock lock(verticiesMutex);
+
+    combinedVerticies.clear();
+    for (const auto& verticies : sectionVerticies) {
+        combinedVerticies.insert(combinedVerticies.end(), verticies.begin(), verticies.end());
+    }
+
+    readyToBind = true;
+}
+
+void MaterialMesh::ClearMesh() {
+    // Draw nothing until rebound, but keep the vertex array capacity and buffers for reuse
+    ResetVerticies();
+    boundFaces = 0;
+}
+
 void MaterialMesh::BindMesh() {
+    // Take the combined verticies, unless the sections were replaced again since the mesh was marked ready to bind
+    {
+        std::unique_lock lock(verticiesMutex);
+        if (!readyToBind) return;
+
+        vertexArray.swap(combinedVerticies);
+        readyToBind = false;
+    }
+
     if (vertexArrayObject == 0) {
         // For when the material mesh is created by the chunk meshing thread
         glGenVertexArrays(1, &vertexArrayObject);
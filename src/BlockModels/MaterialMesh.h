@@ -6,15 +6,23 @@
 #define UNTITLED7_MATERIALMESH_H
 
 #include <glew.h>
+#include <atomic>
+#include <mutex>
 
 #include "Block.h"
 #include "../Window.h"
+#include "../World/WorldGenConsts.h"
 
 
 /*
  * Used to merge together multiple instances of a singular block type into a single mesh of verticies. Permits far
  * greater optimisation of drawing. Verticies for the object should be provided by determining the visible faces at a
  * given position, and passing that position and the vertex data of the visible faces to AddVerticies.
+ *
+ * Verticies are held separately for each chunk section, so that a single section of the mesh can be recreated without
+ * recreating the rest. Sections are built separately from the mesh, then replace the mesh's verticies for that section
+ * through SetSectionVerticies. The meshing thread combines the sections once they are all replaced, and the combined
+ * verticies are handed to the main thread when the mesh is bound.
  */
 
 class MaterialMesh {
@@ -24,31 +32,41 @@ class MaterialMesh {
         unsigned int vertexBufferObject {};
         unsigned int indexBufferObject {};
 
-        Block* block;
+        const Block* block;
 
         int bufferVerticiesSize = 0;
         int bufferIndiciesSize = 0;
         int boundFaces = 0;
 
-        bool oldMesh = true;
-        bool readyToBind = false;
+        std::atomic<bool> oldMesh = true;
+        std::atomic<bool> readyToBind = false;
 
     private:
+        // Section and combined verticies are shared between the meshing and main threads. The vertex array is only used
+        // by the main thread
+        std::mutex verticiesMutex;
+        std::array<std::vector<UniqueVertex>, chunkSections> sectionVerticies {};
+        std::vector<UniqueVertex> combinedVerticies {};
         std::vector<UniqueVertex> vertexArray {};
 
     public:
-        explicit MaterialMesh(Block* _block);
+        using SectionVerticies = std::array<std::vector<UniqueVertex>, chunkSections>;
+
+        explicit MaterialMesh(const Block* _block);
         ~MaterialMesh();
 
         // Mesh verticies setup and binding
-        virtual void AddVerticies(const std::vector<UniqueVertex>& _verticies, const glm::vec3& _position);
+        static void AddVerticies(std::vector<UniqueVertex>* _sectionVerticies,
+                                 const std::vector<UniqueVertex>& _verticies, const glm::vec3& _position);
+        virtual void SetSectionVerticies(int _section, std::vector<UniqueVertex>&& _verticies);
         virtual void ResetVerticies();
+        virtual void CombineSectionVerticies();
+        virtual void ClearMesh();
         virtual void BindMesh();
         virtual void UpdateMesh();
 
         // Mark meshes for recreation
         void MarkOld() { oldMesh = true; }
-        void MarkReadyToBind() {readyToBind = true; }
         [[nodiscard]] bool IsOld() const { return oldMesh; }
         [[nodiscard]] bool ReadyToBind() const { return readyToBind; }
 
@@ -56,7 +74,7 @@ class MaterialMesh {
         virtual void DrawMesh(const Transformation& _transformation) const;
 
         // Getters
-        [[nodiscard]] Block* GetBlock() const { return block; }
+        [[nodiscard]] const Block* GetBlock() const { return block; }
 };
 
 
@@ -0,0 +1,86 @@
+#include "BlockRegistry.h"
+
+#include "CreateBlock.h"
+#include "../ErrorLogging.h"
+
+BlockRegistry::BlockRegistry() {
+    for (auto& state : stateIDs) state.store(unregisteredState, std::memory_order_relaxed);
+
+    // Air must be state 0, so that zeroed state data is air
+    RegisterBlockType({AIR, 0});
+}
+
+
+
+/*
+ * Creates the Block instance and BlockStateID for a new BlockType. If another thread registered the same BlockType
+ * first, its BlockStateID is returned instead.
+ */
+
+BlockStateID BlockRegistry::RegisterBlockType(const BlockType &_blockType) {
+    std::unique_lock lockGuard(registryLock);
+
+    std::atomic<BlockStateID>& typeState = stateIDs[GetTypeIndex(_blockType)];
+    if (typeState.load(std::memory_order_relaxed) != unregisteredState) return typeState.load(std::memory_order_relaxed);
+
+    if (nBlockStates == maxBlockStates) {
+        LogError("Block registry is full, block type replaced with air", std::to_string(_blockType.blockID).c_str());
+        return airState;
+    }
+
+    // The Block must be stored before the state is published to other threads
+    auto newState = BlockStateID(nBlockStates++);
+    blockTypes[newState] = _blockType;
+    blocks[newState] = CreateBlock(_blockType);
+    SetStateProperties(newState, *blocks[newState]);
+    typeState.store(newState, std::memory_order_release);
+
+    return newState;
+}
+
+
+
+/*
+ * Copies the shared attributes of the state's block into the property table
+ */
+
+void BlockRegistry::SetStateProperties(BlockStateID _state, const Block &_block) {
+    std::array<std::pair<BLOCKATTRIBUTE, BLOCKFLAG>, 9> attributeFlags {{
+        {BLOCKATTRIBUTE::TRANSPARENT, FLAG_TRANSPARENT},
+        {BLOCKATTRIBUTE::OBSCURES_SELF, FLAG_OBSCURES_SELF},
+        {BLOCKATTRIBUTE::LIQUID, FLAG_LIQUID},
+        {BLOCKATTRIBUTE::BREAKABLE, FLAG_BREAKABLE},
+        {BLOCKATTRIBUTE::CANACCESSTHROUGHBLOCK, FLAG_CANACCESSTHROUGHBLOCK},
+        {BLOCKATTRIBUTE::ENTITYCOLLISIONSOLID, FLAG_ENTITYCOLLISIONSOLID},
+        {BLOCKATTRIBUTE::CANOCCLUDE, FLAG_CANOCCLUDE},
+        {BLOCKATTRIBUTE::CANBEOCCLUDED, FLAG_CANBEOCCLUDED},
+        {BLOCKATTRIBUTE::CANHAVESUBBLOCKPOSITION, FLAG_CANHAVESUBBLOCKPOSITION},
+    }};
+
+    uint16_t flags = 0;
+    for (const auto& [attribute, flag] : attributeFlags) {
+        if (_block.GetSharedAttribute(attribute) > 0) flags |= flag;
+    }
+
+    stateFlags[_state] = flags;
+    stateTransparency[_state] = _block.GetSharedAttribute(BLOCKATTRIBUTE::TRANSPARENT);
+    stateGenerationPriority[_state] = _block.GetSharedAttribute(BLOCKATTRIBUTE::GENERATIONPRIORITY);
+    stateModel[_state] = (BLOCKMODEL)_block.GetSharedAttribute(BLOCKATTRIBUTE::BLOCKMODEL);
+}
+
+
+
+/*
+ * Equivalent to Block::BlockFaceVisible, using the property table. Faces are hidden by opaque blocks, and transparent
+ * blocks hide back, left or bottom faces against the same block unless the block obscures itself on every face.
+ */
+
+bool BlockRegistry::FaceVisible(BlockStateID _checkingState, BlockStateID _faceState, BLOCKFACE _face) const {
+    if (!HasFlag(_faceState, FLAG_TRANSPARENT)) return false;
+
+    if (_faceState == _checkingState && HasFlag(_checkingState, FLAG_TRANSPARENT)) {
+        if (HasFlag(_faceState, FLAG_OBSCURES_SELF) || _face == BACK || _face == LEFT || _face == BOTTOM) return false;
+    }
+
+    return true;
+}
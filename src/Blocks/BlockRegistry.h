@@ -0,0 +1,92 @@
+#ifndef UNTITLED7_BLOCKREGISTRY_H
+#define UNTITLED7_BLOCKREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+#include "../BlockModels/Block.h"
+
+// Dense id given to every BlockType (blockID + variantID) by the block registry
+typedef uint16_t BlockStateID;
+
+static const BlockStateID airState = 0;
+static const int maxBlockStates = 1024;
+
+/*
+ * Bitflags of the boolean shared block attributes, stored per block state in the registry's property table
+ */
+
+enum BLOCKFLAG : uint16_t {
+    FLAG_TRANSPARENT = 1 << 0,
+    FLAG_OBSCURES_SELF = 1 << 1,
+    FLAG_LIQUID = 1 << 2,
+    FLAG_BREAKABLE = 1 << 3,
+    FLAG_CANACCESSTHROUGHBLOCK = 1 << 4,
+    FLAG_ENTITYCOLLISIONSOLID = 1 << 5,
+    FLAG_CANOCCLUDE = 1 << 6,
+    FLAG_CANBEOCCLUDED = 1 << 7,
+    FLAG_CANHAVESUBBLOCKPOSITION = 1 << 8,
+};
+
+/*
+ * Process-wide registry of every BlockType in use. Each BlockType is given a dense BlockStateID the first time it is
+ * requested, along with a single immutable Block instance that is shared by all chunks. Chunks store BlockStateIDs, so
+ * fetching a block's type or Block instance is an array lookup rather than a hash lookup. {AIR, 0} is always state 0.
+ *
+ * The shared attributes of each state are also copied into a flat property table when the state is registered, so
+ * that hot loops can test a block's attributes with a single load, rather than going through Block::GetSharedAttribute.
+ */
+
+class BlockRegistry {
+    private:
+        // BlockType to BlockStateID, indexed by GetTypeIndex
+        static const BlockStateID unregisteredState = UINT16_MAX;
+        std::array<std::atomic<BlockStateID>, 256 * 256> stateIDs {};
+
+        // BlockStateID to BlockType and Block. Blocks are never removed, so references remain valid for the registry's
+        // lifetime
+        std::array<BlockType, maxBlockStates> blockTypes {};
+        std::array<std::unique_ptr<const Block>, maxBlockStates> blocks {};
+
+        // Property table of each BlockStateID
+        std::array<uint16_t, maxBlockStates> stateFlags {};
+        std::array<GLbyte, maxBlockStates> stateTransparency {};
+        std::array<GLbyte, maxBlockStates> stateGenerationPriority {};
+        std::array<BLOCKMODEL, maxBlockStates> stateModel {};
+        int nBlockStates = 0;
+        std::mutex registryLock;
+
+        [[nodiscard]] static int GetTypeIndex(const BlockType& _blockType) {
+            return int(_blockType.blockID) * 256 + uint8_t(_blockType.variantID);
+        }
+
+        BlockStateID RegisterBlockType(const BlockType& _blockType);
+        void SetStateProperties(BlockStateID _state, const Block& _block);
+
+    public:
+        BlockRegistry();
+
+        // BlockType to BlockStateID, registering the BlockType if it is new
+        [[nodiscard]] BlockStateID GetStateID(const BlockType& _blockType) {
+            BlockStateID state = stateIDs[GetTypeIndex(_blockType)].load(std::memory_order_acquire);
+            return (state != unregisteredState) ? state : RegisterBlockType(_blockType);
+        }
+
+        // BlockStateID lookups. The state must have been obtained from GetStateID
+        [[nodiscard]] const Block& GetBlock(BlockStateID _state) const { return *blocks[_state]; }
+        [[nodiscard]] BlockType GetBlockType(BlockStateID _state) const { return blockTypes[_state]; }
+
+        // Property table lookups
+        [[nodiscard]] bool HasFlag(BlockStateID _state, BLOCKFLAG _flag) const { return (stateFlags[_state] & _flag) != 0; }
+        [[nodiscard]] GLbyte GetTransparency(BlockStateID _state) const { return stateTransparency[_state]; }
+        [[nodiscard]] GLbyte GetGenerationPriority(BlockStateID _state) const { return stateGenerationPriority[_state]; }
+        [[nodiscard]] BLOCKMODEL GetBlockModel(BlockStateID _state) const { return stateModel[_state]; }
+        [[nodiscard]] bool FaceVisible(BlockStateID _checkingState, BlockStateID _faceState, BLOCKFACE _face) const;
+};
+
+inline std::unique_ptr<BlockRegistry> blockRegistry {};
+
+#endif //UNTITLED7_BLOCKREGISTRY_H
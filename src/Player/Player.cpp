@@ -291,13 +291,14 @@ void Player::UpdatePlayerChunk() {
     // If players chunk is not the same as currently stored player chunk, update the world's loading origin
     if (pChunk != nullptr) {
         if (pChunk != playerChunk && playerChunk != nullptr) {
-            world->SetLoadingOrigin(pChunk->GetIndex());
-            world->GenerateLoadableWorldRegion();
-
-            // Ensure that chunks are loaded / unloaded accordingly
-            world->ManageLoadedChunks(playerChunk, pChunk);
+            // Load the chunks entering the region and unload the chunks leaving it
+            world->StreamWorldRegion(pChunk->GetIndex());
         }
 
+        // Generate the chunks ahead of the player before they are reached
+        world->PrefetchWorldRegion(vectorSpeed, facingDirection);
+        world->FocusChunkJobs(facingDirection);
+
         // update player chunk
         playerChunk = pChunk;
     }
@@ -311,8 +312,25 @@ void Player::UpdateMaxPositions() {
     // Get block position in chunk player is currently inside of
     glm::vec3 blockPos = position - (playerChunk->GetIndex() * (float)chunkSize);
 
+    // When the player is above every column beneath them, the floor is the highest solid block of those columns, which
+    // the heightmaps hold without searching the blocks
+    int highestSolid = -1;
+    bool aboveColumns = true;
+    for (float xOffset : {-radius, 0.0f, radius}) {
+        for (float zOffset : {-radius, 0.0f, radius}) {
+            glm::vec3 columnPos = {blockPos.x + xOffset, 0, blockPos.z + zOffset};
+            int columnHeight = playerChunk->GetColumnHeightAtPosition(HIGHEST_SOLID, columnPos);
+
+            // A column reaching the players feet may have blocks above them, so the blocks must still be searched
+            if ((float)columnHeight + 1.0f > blockPos.y + 0.2f) aboveColumns = false;
+            highestSolid = std::max(highestSolid, columnHeight);
+        }
+    }
+
     // Get the highest ylevel that the player would reach first
-    minY = playerChunk->GetTopLevelAtPosition({blockPos.x, blockPos.y - 1, blockPos.z}, 0.4f);
+    if (!aboveColumns) minY = playerChunk->GetTopLevelAtPosition({blockPos.x, blockPos.y - 1, blockPos.z}, radius);
+    else if (highestSolid == -1) minY = -20;
+    else minY = 1.0f + (float)highestSolid + playerChunk->GetIndex().y * (float)chunkSize;
     maxY = chunkHeight;
 
     // returns position of obstructing face in the chunk
@@ -418,6 +436,9 @@ void Player::MouseLook(SDL_bool _mouseGrabbed) {
     usingCamera->SetDirection(facingDirection);
     usingCamera->SetAngle(angleVert, angleHoriz);
 
+    // Build the chunks coming into view first
+    world->FocusChunkJobs(facingDirection);
+
     // Return mouse to centre
     SDL_WarpMouseInWindow(window.WindowPtr(), maxx/2, maxy/2);
 
@@ -450,6 +471,24 @@ void Player::HandlePlayerInputs(const SDL_Event &_event) {
         mouseScroll += (float)_event.wheel.y * scrollSensitivity;
         SelectHotbarItem();
     }
+
+    // Increase or decrease the view distances by a chunk
+    if (_event.type == SDL_KEYDOWN && _event.key.repeat == 0) {
+        switch (_event.key.keysym.scancode) {
+            case SDL_SCANCODE_EQUALS:
+                world->SetViewDistances(world->GetLoadRadius() + 1, world->GetMeshRadius() + 1,
+                                        world->GetRenderRadius() + 1);
+                break;
+
+            case SDL_SCANCODE_MINUS:
+                world->SetViewDistances(world->GetLoadRadius() - 1, world->GetMeshRadius() - 1,
+                                        world->GetRenderRadius() - 1);
+                break;
+
+            default:
+                break;
+        }
+    }
 }
 
 void Player::GetUnobstructedRayPosition() {
@@ -487,7 +526,6 @@ void Player::GetUnobstructedRayPosition() {
 }
 
 void Player::BreakBlock(glm::vec3 _rayPosition) {
-    using namespace std::placeholders;
     if (!lookingAtInteractable) return;
 
     // Ensure block is breakable by player
@@ -498,27 +536,22 @@ void Player::BreakBlock(glm::vec3 _rayPosition) {
     // Break block
     playerChunk->BreakBlockAtPosition(_rayPosition);
 
-    // Add the chunks and the region to the chunk mesher thread as priority
-    ChunkThreads* mesher = world->GetThread(THREAD::CHUNKMESHING);
-
+    // Add the chunks and the region to the chunk jobs as priority meshing
     glm::ivec2 pos{playerChunk->GetIndex().x, playerChunk->GetIndex().z};
-    ThreadAction action{std::bind(&World::GenerateChunkMesh, world.get(), _1, _2), pos};
-    mesher->AddPriorityActionRegion(action, 1, true);
+    ThreadAction action{pos};
+    world->GetJobPool()->AddJobRegion(JOBKIND::MESH, action, 1, true, true);
 }
 
 void Player::PlaceBlock(glm::vec3 _rayPosition) {
-    using namespace std::placeholders;
     if (!lookingAtInteractable) return;
 
     _rayPosition -= glm::normalize(facingDirection) * (range/20.0f);
     playerChunk->PlaceBlockAtPosition(_rayPosition, blockInHandType);
 
-    // Add the chunks and the region to the chunk mesher thread as priority
-    ChunkThreads* mesher = world->GetThread(THREAD::CHUNKMESHING);
-
+    // Add the chunks and the region to the chunk jobs as priority meshing
     glm::ivec2 pos{playerChunk->GetIndex().x, playerChunk->GetIndex().z};
-    ThreadAction action{std::bind(&World::GenerateChunkMesh, world.get(), _1, _2), pos};
-    mesher->AddPriorityActionRegion(action, 1, true);
+    ThreadAction action{pos};
+    world->GetJobPool()->AddJobRegion(JOBKIND::MESH, action, 1, true, true);
 }
 
 
@@ -5,6 +5,8 @@
 #ifndef UNTITLED7_BIOME_H
 #define UNTITLED7_BIOME_H
 
+#include <mutex>
+
 #include "../../BlockModels/Block.h"
 
 #include "../WorldGenConsts.h"
@@ -45,14 +47,15 @@ class Biome {
         };
 
         Biome();
-        ~Biome();
+        virtual ~Biome();
 
         // Biome Block and Decorative Foliage Generation
         [[nodiscard]] virtual BlockType GetBlockType(float _hmTopLevel, float _blockY);
         [[nodiscard]] virtual FOLIAGE GetFoliage(float _plantDensity);
         [[nodiscard]] virtual BlockType BuildFoliage(FOLIAGE _foliageType, float _plantDensity, int* _height);
 
-        // Large Structure Gen
+        // Large Structure Gen. The structure lock must be held whilst loading and building a structure
+        [[nodiscard]] std::unique_lock<std::mutex> LockStructure() { return std::unique_lock(structureLock); }
         void LoadStructure(STRUCTURES _structure);
         [[nodiscard]] StructBlockData BuildStructure(bool* _completed, float _solidity);
 
@@ -73,6 +76,7 @@ class Biome {
         // Biome Foliage Structures
         StructureData loadedStructData;
         size_t structBlocksRemaining = 0;
+        std::mutex structureLock;
         StructureLoader loader = StructureLoader();
 
         // Biome Foliage Gen Levels
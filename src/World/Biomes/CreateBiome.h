@@ -39,6 +39,8 @@ inline Biome::ID GetBiomeIDFromData(const ChunkData& _chunkData) {
 
 /*
  * CONSTRUCT ACTUAL BIOME FROM BIOMEID
+ * The biome is kept as its own type, so that the generation parameters of each biome (see Mountains, Hills, Plains,
+ * Beach and OceanShores) shape the terrain, rather than those of the base Biome
  */
 
 inline std::unique_ptr<Biome> CreateBiome(Biome::ID _biomeID) {
@@ -70,7 +72,7 @@ inline std::unique_ptr<Biome> CreateBiome(Biome::ID _biomeID) {
             biome = new Biome();
     }
 
-    return std::make_unique<Biome>(*biome);
+    return std::unique_ptr<Biome>(biome);
 }
 
 /*
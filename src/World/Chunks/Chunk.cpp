@@ -7,8 +7,8 @@
 #include <glm/gtc/noise.hpp>
 #include <memory>
 #include <utility>
+#include <bit>
 
-#include "../../Blocks/CreateBlock.h"
 #include "../../GlobalStates.h"
 #include "../Structures/LoadStructure.h"
 #include "../World.h"
@@ -18,6 +18,28 @@
  */
 
 Chunk::Chunk(const glm::vec3& _chunkPosition, ChunkData _chunkData) {
+    // Create bounding box for the chunk (assume max 16x256x16 volume)
+    boxBounds = std::move(GenerateBoxBounds({{glm::vec3(0,0,0)},
+                                             {glm::vec3(chunkSize,chunkHeight,chunkSize)}}));
+
+    Reset(_chunkPosition, _chunkData);
+}
+
+Chunk::~Chunk() {
+    uniqueMeshMap.clear();
+
+//    printf("CHUNK AT %f %f DESTROYED\n", chunkIndex.x, chunkIndex.z);
+};
+
+
+
+/*
+ * Sets up the chunk at the given position with empty terrain. Used by the constructor, and by ChunkPool to recycle an
+ * unloaded chunk in place, keeping the terrain section storages and the block meshes (and their buffers) of the chunk
+ * it replaces.
+ */
+
+void Chunk::Reset(const glm::vec3& _chunkPosition, const ChunkData& _chunkData) {
     // Update the chunkPosition and chunkBounds transformations
     displayTransformation.SetPosition(_chunkPosition * (float)chunkSize);
     displayTransformation.UpdateModelMatrix();
@@ -25,23 +47,35 @@ Chunk::Chunk(const glm::vec3& _chunkPosition, ChunkData _chunkData) {
     cullingTransformation.SetPosition(_chunkPosition * (float)chunkSize);
     cullingTransformation.UpdateModelMatrix();
 
-    // Set chunk position
+    // Set chunk position and chunkData
     chunkIndex = _chunkPosition;
+    chunkPos = ::GetChunkPos(_chunkPosition);
+    chunkData = _chunkData;
 
-    // Create bounding box for the chunk (assume max 16x256x16 volume)
-    boxBounds = std::move(GenerateBoxBounds({{glm::vec3(0,0,0)},
-                                             {glm::vec3(chunkSize,chunkHeight,chunkSize)}}));
+    inCamera = true;
+    needsMeshUpdates = false;
+    unboundMeshChanges = false;
+    generated = false;
+    generationStarted = false;
+
+    // Chunk terrain starts as air. Bumping the version discards mesh work started on the previous chunk
+    terrainVersion.fetch_add(1, std::memory_order_release);
+    for (auto& section : terrainSections) section.Reset();
+    for (auto& plane : blockPlanes) {
+        for (auto& column : plane) column.fill(0);
+    }
+    for (auto& heightMap : columnHeights) {
+        for (auto& columnHeight : heightMap) columnHeight.store(-1, std::memory_order_relaxed);
+    }
 
-    // Set chunkData
-    chunkData = _chunkData;
-}
+    meshUpdateSections = 0;
 
-Chunk::~Chunk() {
-    uniqueBlockMap.clear();
-    uniqueMeshMap.clear();
+    // Links to the previous chunk's neighbours were cleared when it was unloaded
+    for (auto& adjacentChunk : adjacentChunks) adjacentChunk.store(nullptr, std::memory_order_relaxed);
 
-//    printf("CHUNK AT %f %f DESTROYED\n", chunkIndex.x, chunkIndex.z);
-};
+    // Meshes of the previous chunk are emptied, so they draw nothing until the new terrain is meshed
+    for (auto& mesh : uniqueMeshMap) mesh.second->ClearMesh();
+}
 
 
 
@@ -95,91 +129,238 @@ void Chunk::DisplayTransparent() {
 
 
 /*
- * Updates the mesh of a given block. This block must belong to the unique blocks of the chunk, otherwise the blockMesh
- * will not be obtained, even if it is the same blockType being updated.
+ * Updates the mesh of a given block.
  */
 
-void Chunk::UpdateBlockMesh(Block* _meshBlock) {
+void Chunk::UpdateBlockMesh(const Block* _meshBlock) {
     MaterialMesh* blockMesh = GetMeshFromBlock(_meshBlock->GetBlockType());
     if (blockMesh == nullptr || blockMesh->GetBlock()->GetBlockType().blockID == AIR) return;
 
-    blockMesh->ResetVerticies();
+    ChunkSnapshot snapshot;
+    CreateSnapshot(&snapshot);
 
-    for (int x = 0; x < chunkSize; x++) {
-        for (int z = 0; z < chunkSize; z++) {
-            for (int y = 0; y < chunkHeight; y++) {
-                ChunkDataTypes::ChunkBlock block = GetBlockAtPosition({x,y,z});
-                Block blockPtr = GetBlockFromData(block.type);
-
-                if (block.type == _meshBlock->GetBlockType()) {
-                    std::vector<UniqueVertex> verticies = blockPtr.GetFaceVerticies(
-                            GetShowingFaces({x,y,z}, blockPtr),
-                            block.attributes);
-                    blockMesh->AddVerticies(verticies, {x,y,z});
+    MaterialMesh::SectionVerticies meshVerticies;
+
+    BlockStateID meshState = blockRegistry->GetStateID(_meshBlock->GetBlockType());
+    for (int s = 0; s < chunkSections; s++) {
+        if (snapshot.SectionEmpty(s)) continue;
+
+        for (int y = s * sectionSize; y < (s + 1) * sectionSize; y++) {
+            for (int x = 0; x < chunkSize; x++) {
+                for (int z = 0; z < chunkSize; z++) {
+                    if (snapshot.GetBlockState(x, y, z) != meshState) continue;
+
+                    std::vector<UniqueVertex> verticies = _meshBlock->GetFaceVerticies(
+                            GetShowingFaces(snapshot, {x,y,z}, meshState), snapshot.GetAttributes(x, y, z));
+                    MaterialMesh::AddVerticies(&meshVerticies[s], verticies, {x,y,z});
                 }
             }
         }
     }
 
+    // The terrain changed during meshing, so leave the mesh as it was for the full mesh update that follows
+    if (GetTerrainVersion() != snapshot.terrainVersion) {
+        meshUpdateSections.fetch_or((1u << chunkSections) - 1);
+        needsMeshUpdates = true;
+        return;
+    }
+
+    for (int s = 0; s < chunkSections; s++) blockMesh->SetSectionVerticies(s, std::move(meshVerticies[s]));
+    blockMesh->CombineSectionVerticies();
+
     needsMeshUpdates = false;
     unboundMeshChanges = true;
 }
 
 /*
- * Goes through all positions within the chunk and adds the visible verticies of blocks to their corresponding meshes.
- * Can affect all meshes except any potential air mesh.
- * Will only act upon meshes where "oldMesh" is true
+ * Goes through all positions within the sections marked for mesh updates and adds the visible verticies of blocks to
+ * their corresponding meshes, replacing the verticies each mesh had for those sections. Can affect all meshes except any
+ * potential air mesh. Returns false, leaving the meshes unchanged, if the terrain changed whilst the meshes were being
+ * created.
  */
 
-void Chunk::CreateChunkMeshes() {
-    for (auto& mesh : uniqueMeshMap) {
-        if (mesh.second->IsOld()) {
-            mesh.second->ResetVerticies();
-        }
-    }
+bool Chunk::CreateChunkMeshes() {
+    // Another job is meshing the chunk, so mesh again once it is done
+    std::unique_lock meshingLock(meshingMutex, std::try_to_lock);
+    if (!meshingLock.owns_lock()) return false;
+
+    // Cleared before copying the terrain, so that edits made whilst meshing request another mesh update
+    needsMeshUpdates = false;
+    uint32_t meshingSections = meshUpdateSections.exchange(0);
+    if (meshingSections == 0) return true;
+
+    // Copy the sections being meshed, the sections either side, and the bordering blocks of adjacent chunks, so
+    // meshing does not access the world or the live terrain
+    int minSection = std::countr_zero(meshingSections);
+    int maxSection = 31 - std::countl_zero(meshingSections);
+
+    ChunkSnapshot snapshot;
+    CreateSnapshot(&snapshot, std::max(minSection - 1, 0), std::min(maxSection + 1, chunkSections - 1));
 
-    for (int x = 0; x < chunkSize; ++x) {
-        for (int z = 0; z < chunkSize; ++z) {
-            for (int y = 0; y < chunkHeight; ++y) {
-                ChunkDataTypes::ChunkBlock block = GetChunkBlockAtPosition({x,y,z});
-                if (block.type.blockID == AIR) continue;
+    // The verticies of each mesh are built aside, so the meshes keep their previous verticies if this mesh is discarded
+    std::unordered_map<MaterialMesh*, MaterialMesh::SectionVerticies> meshVerticies;
 
-                MaterialMesh* blockMesh = GetMeshFromBlock(block.type);
-                if (!blockMesh->IsOld()) continue;
+    for (int s = minSection; s <= maxSection; ++s) {
+        if (((meshingSections >> s) & 1) == 0) continue;
 
-                // Get Visible Verticies
-                Block blockPtr = GetBlockFromData(block.type);
-                std::vector<UniqueVertex> verticies = blockPtr.GetFaceVerticies(
-                        GetShowingFaces({x,y,z}, blockPtr),
-                        block.attributes);
+        // Sections of only air have nothing to mesh, and enclosed sections have no visible faces
+        if (snapshot.SectionEmpty(s) || snapshot.SectionEnclosed(s)) continue;
 
-                // Calculate Occlusion
-                CalculateOcclusion(verticies, blockPtr, {x,y,z});
+        for (int y = s * sectionSize; y < (s + 1) * sectionSize; ++y) {
+            for (int x = 0; x < chunkSize; ++x) {
+                for (int z = 0; z < chunkSize; ++z) {
+                    BlockStateID blockState = snapshot.GetBlockState(x, y, z);
+                    if (blockState == airState) continue;
 
-                // Add to blockMesh
-                blockMesh->AddVerticies(verticies, {x,y,z});
+                    MaterialMesh* blockMesh = GetMeshFromState(blockState);
+
+                    // Get Visible Verticies
+                    std::vector<UniqueVertex> verticies = blockRegistry->GetBlock(blockState).GetFaceVerticies(
+                            GetShowingFaces(snapshot, {x,y,z}, blockState), snapshot.GetAttributes(x, y, z));
+
+                    // Calculate Occlusion
+                    CalculateOcclusion(verticies, snapshot, blockState, {x,y,z});
+
+                    // Add to blockMesh
+                    MaterialMesh::AddVerticies(&meshVerticies[blockMesh][s], verticies, {x,y,z});
+                }
             }
         }
     }
 
+    // The terrain changed during meshing, so the verticies may be built from a mix of old and new blocks. Discard them,
+    // leaving the meshes as they were for the next mesh update
+    if (GetTerrainVersion() != snapshot.terrainVersion) {
+        meshUpdateSections.fetch_or(meshingSections);
+        needsMeshUpdates = true;
+        return false;
+    }
+
+    // Replace the meshed sections of every mesh, emptying them in meshes with no blocks left in those sections
     for (auto& mesh : uniqueMeshMap) {
+        auto builtVerticies = meshVerticies.find(mesh.second.get());
+
+        for (int s = minSection; s <= maxSection; ++s) {
+            if (((meshingSections >> s) & 1) == 0) continue;
+
+            if (builtVerticies == meshVerticies.end()) mesh.second->SetSectionVerticies(s, {});
+            else mesh.second->SetSectionVerticies(s, std::move(builtVerticies->second[s]));
+        }
+
         if (mesh.second->IsOld()) {
-            mesh.second->MarkReadyToBind();
+            mesh.second->CombineSectionVerticies();
         }
     }
 
-    needsMeshUpdates = false;
     unboundMeshChanges = true;
+    return true;
+}
+
+
+
+/*
+ * Copies the block states of the chunk, and the blocks bordering the chunk from each of the 8 surrounding chunks, into
+ * the snapshot, along with the attributes and section flags used by meshing
+ */
+
+void Chunk::CreateSnapshot(ChunkSnapshot* _snapshot, int _minSection, int _maxSection) {
+    auto readGuard = world->ReadChunks();
+
+    _snapshot->terrainVersion = GetTerrainVersion();
+    std::fill(_snapshot->blockStates.begin(), _snapshot->blockStates.end(), airState);
+    for (auto& attributes : _snapshot->sectionAttributes) attributes.clear();
+    _snapshot->emptySections = 0;
+    _snapshot->opaqueSections.fill(0);
+
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            // The range of the source chunk's blocks which border this chunk, and their position in this chunk
+            int minX = (dx == -1) ? chunkSize - 1 : 0;
+            int maxX = (dx == 0) ? chunkSize : minX + 1;
+            int minZ = (dz == -1) ? chunkSize - 1 : 0;
+            int maxZ = (dz == 0) ? chunkSize : minZ + 1;
+
+            if (dx == 0 && dz == 0) {
+                CopyToSnapshot(_snapshot, minX, maxX, minZ, maxZ, 0, 0, _minSection, _maxSection);
+                continue;
+            }
+
+            Chunk* adjChunk = GetAdjacentChunk(dx, dz);
+            if (adjChunk != nullptr)
+                adjChunk->CopyToSnapshot(_snapshot, minX, maxX, minZ, maxZ, dx * chunkSize, dz * chunkSize,
+                                         _minSection, _maxSection);
+        }
+    }
+}
+
+/*
+ * Copies the block states within the given x and z range (upper bound exclusive) of the given sections into the
+ * snapshot, offset by the position of this chunk relative to the snapshot's chunk. The snapshot's own chunk also copies
+ * its unique attributes and empty sections.
+ */
+
+void Chunk::CopyToSnapshot(ChunkSnapshot* _snapshot, int _minX, int _maxX, int _minZ, int _maxZ, int _offsetX,
+                           int _offsetZ, int _minSection, int _maxSection) {
+    bool snapshotChunk = (_offsetX == 0 && _offsetZ == 0);
+    int neighbourIndex = ChunkSnapshot::GetNeighbourIndex(_offsetX / chunkSize, _offsetZ / chunkSize);
+
+    for (int s = _minSection; s <= _maxSection; s++) {
+        ChunkSection& section = terrainSections[s];
+
+        BlockStateID uniformState;
+        bool uniform = section.IsUniform(&uniformState);
+        if (uniform && !blockRegistry->HasFlag(uniformState, FLAG_TRANSPARENT)) {
+            _snapshot->opaqueSections[neighbourIndex] |= uint32_t(1) << s;
+        }
+
+        if (snapshotChunk) {
+            if (section.IsEmpty()) _snapshot->emptySections |= uint32_t(1) << s;
+            section.CopyUniqueAttributes(&_snapshot->sectionAttributes[s]);
+        }
+
+        // Uniform sections of air are already set
+        if (uniform && uniformState == airState) continue;
+
+        for (int y = s * sectionSize; y < (s + 1) * sectionSize; y++) {
+            for (int z = _minZ; z < _maxZ; z++) {
+                for (int x = _minX; x < _maxX; x++) {
+                    BlockStateID blockState = uniform ? uniformState :
+                            section.GetBlockState(ChunkSection::GetBlockIndex(x, y % sectionSize, z));
+                    _snapshot->blockStates[ChunkSnapshot::GetIndex(x + _offsetX, y, z + _offsetZ)] = blockState;
+                }
+            }
+        }
+    }
 }
 
 
 
 void Chunk::MarkForMeshUpdates() {
+    meshUpdateSections.store((uint32_t(1) << chunkSections) - 1);
+    needsMeshUpdates = true;
+}
+
+/*
+ * Marks the section containing the y level for mesh updates, along with the section above or below if the y level is on
+ * the section's border, as the faces of the blocks there depend on it
+ */
+
+void Chunk::MarkSectionsForMeshUpdates(int _y) {
+    if (_y < 0 || _y >= chunkHeight) return;
+
+    int section = _y / sectionSize;
+    uint32_t sections = uint32_t(1) << section;
+    if (_y % sectionSize == 0 && section > 0) sections |= uint32_t(1) << (section - 1);
+    if (_y % sectionSize == sectionSize - 1 && section < chunkSections - 1) sections |= uint32_t(1) << (section + 1);
+
+    meshUpdateSections.fetch_or(sections);
     needsMeshUpdates = true;
 }
 
 
 void Chunk::BindChunkMeshes() {
+    // Prevent creation of new meshes whilst binding
+    std::unique_lock lock(meshMutex);
     for (auto& mesh : uniqueMeshMap) {
         if (mesh.second->ReadyToBind()) {
             mesh.second->BindMesh();
@@ -201,24 +382,22 @@ std::vector<BLOCKFACE> Chunk::GetHiddenFaces(glm::vec3 _blockPos) {
             glm::vec3{0, 1, 0}, glm::vec3{0, -1, 0}, glm::vec3{-1, 0, 0},
             glm::vec3{1,0,0}, glm::vec3{0, 0, 1}, glm::vec3{0, 0, -1}};
 
-    ChunkDataTypes::ChunkBlock checkingBlock = GetBlockAtPosition(_blockPos);
-    if (checkingBlock.type == BlockType{AIR, 0}) return faces; // Air block
-    Block checkingPtr = GetBlockFromData(checkingBlock.type);
+    BlockStateID checkingState = GetBlockStateAtPosition(_blockPos);
+    if (checkingState == airState) return faces; // Air block
 
     for (int i = 0; i < faces.size(); i++) {
-        ChunkDataTypes::ChunkBlock blockAtFace = GetBlockAtPosition(_blockPos + positionOffsets[i]);
-        Block facePtr = GetBlockFromData(blockAtFace.type);
+        BlockStateID faceState = GetBlockStateAtPosition(_blockPos + positionOffsets[i]);
 
         // transparent blocks only show when there is air
-        if (checkingPtr.GetSharedAttribute(BLOCKATTRIBUTE::TRANSPARENT) > 0) {
+        if (blockRegistry->HasFlag(checkingState, FLAG_TRANSPARENT)) {
             // Is air, face is not hidden
-            if (checkingBlock.type != BlockType{AIR, 0}) {
+            if (checkingState != airState) {
                 continue;
             }
         }
 
         // Normal blocks may show if the block on the face is transparent
-        else if (facePtr.GetSharedAttribute(BLOCKATTRIBUTE::TRANSPARENT) > 0) {
+        else if (blockRegistry->HasFlag(faceState, FLAG_TRANSPARENT)) {
             continue;
         }
 
@@ -234,21 +413,22 @@ std::vector<BLOCKFACE> Chunk::GetHiddenFaces(glm::vec3 _blockPos) {
  * Returns the FaceIDs of the visible faces of a block at a given position. Faces are considered visible unless fully
  * obscured.
  */
-std::vector<BLOCKFACE> Chunk::GetShowingFaces(glm::vec3 _blockPos, const Block& _checkingBlock) {
-    std::vector<BLOCKFACE> showingFaces {}, checkingFaces = {TOP, BOTTOM, FRONT, BACK, RIGHT, LEFT};
-    std::vector<glm::vec3> positionOffsets {
+std::vector<BLOCKFACE> Chunk::GetShowingFaces(const ChunkSnapshot& _snapshot, glm::vec3 _blockPos,
+                                              BlockStateID _checkingState) {
+    static const std::array<BLOCKFACE, 6> checkingFaces {TOP, BOTTOM, FRONT, BACK, RIGHT, LEFT};
+    static const std::array<glm::vec3, 6> positionOffsets {
             dirTop, dirBottom, dirFront,
             dirBack, dirRight, dirLeft};
 
-    if (_checkingBlock.GetSharedAttribute(BLOCKATTRIBUTE::BLOCKMODEL) == BLOCKMODEL::PLANT)
+    if (blockRegistry->GetBlockModel(_checkingState) == BLOCKMODEL::PLANT)
         return {FRONT, BACK};
 
     // Check for non-transparent block on each face (or non-same transparent block for a transparent block)
+    std::vector<BLOCKFACE> showingFaces {};
     for (int i = 0; i < checkingFaces.size(); i++) {
-        ChunkDataTypes::ChunkBlock faceBlockData = GetBlockAtPosition(_blockPos + positionOffsets[i]);
-        Block faceBlock = GetBlockFromData(faceBlockData.type);
+        BlockStateID faceState = _snapshot.GetBlockState(_blockPos + positionOffsets[i]);
 
-        if (Block::BlockFaceVisible(_checkingBlock, faceBlock, checkingFaces[i]))
+        if (blockRegistry->FaceVisible(_checkingState, faceState, checkingFaces[i]))
             showingFaces.push_back(checkingFaces[i]);
     }
 
@@ -256,15 +436,14 @@ std::vector<BLOCKFACE> Chunk::GetShowingFaces(glm::vec3 _blockPos, const Block&
 }
 
 
-void Chunk::CalculateOcclusion(std::vector<UniqueVertex>& _verticies, Block& _block, const glm::vec3& _position) {
+void Chunk::CalculateOcclusion(std::vector<UniqueVertex>& _verticies, const ChunkSnapshot& _snapshot,
+                               BlockStateID _blockState, const glm::vec3& _position) {
     // No changes necessary
-    if (_block.GetSharedAttribute(BLOCKATTRIBUTE::CANBEOCCLUDED) == 0) return;
+    if (!blockRegistry->HasFlag(_blockState, FLAG_CANBEOCCLUDED)) return;
 
     // Check adjacent blocks for each vertex
     for (auto& vertex : _verticies) {
         // Testing blocks
-        ChunkDataTypes::ChunkBlock chunkBlock;
-        Block block;
         std::array<glm::vec3, 3> adjacentPositions {};              // sideA, sideB, corner
         std::array<bool, 3> adjacentOccluded {false, false, false}; // sideA, sideB, corner
 
@@ -312,11 +491,10 @@ void Chunk::CalculateOcclusion(std::vector<UniqueVertex>& _verticies, Block& _bl
 
         // For each adjacent block
         for (int a = 0; a < 3; a++) {
-            chunkBlock = GetBlockAtPosition(_position + adjacentPositions[a]);
-            block = GetBlockFromData(chunkBlock.type);
+            BlockStateID adjacentState = _snapshot.GetBlockState(_position + adjacentPositions[a]);
 
             // mark block as occluding
-            adjacentOccluded[a] = (block.GetSharedAttribute(BLOCKATTRIBUTE::CANOCCLUDE) == 1);
+            adjacentOccluded[a] = blockRegistry->HasFlag(adjacentState, FLAG_CANOCCLUDE);
 
             // if both sides are occluding, exit early as corner does not impact
             if (adjacentOccluded[0] && adjacentOccluded[1])
@@ -340,12 +518,16 @@ void Chunk::CalculateOcclusion(std::vector<UniqueVertex>& _verticies, Block& _bl
 
 
 MaterialMesh* Chunk::GetMeshFromBlock(const BlockType& _blockType) {
-    if (uniqueMeshMap.count(_blockType) == 0) {
+    return GetMeshFromState(blockRegistry->GetStateID(_blockType));
+}
+
+MaterialMesh* Chunk::GetMeshFromState(BlockStateID _blockState) {
+    if (uniqueMeshMap.count(_blockState) == 0) {
         std::unique_lock lock(meshMutex);
-        uniqueMeshMap[_blockType] = std::make_unique<MaterialMesh>(&GetBlockFromData(_blockType));
+        uniqueMeshMap[_blockState] = std::make_unique<MaterialMesh>(&blockRegistry->GetBlock(_blockState));
     }
 
-    return uniqueMeshMap[_blockType].get();
+    return uniqueMeshMap[_blockState].get();
 }
 
 
@@ -375,6 +557,9 @@ void Chunk::CheckCulling(const Camera& _camera) {
  */
 
 void Chunk::GenerateChunk() {
+    // Another job is already generating the chunk
+    if (generationStarted.exchange(true)) return;
+
     // Populate the terrain array solid/nonSolid
     CreateTerrain();
 
@@ -393,6 +578,72 @@ void Chunk::GenerateChunk() {
 
 
 
+/*
+ * Compresses the chunk's terrain so that it can be restored once the chunk is reloaded
+ */
+
+void Chunk::Compress(CompressedChunk* _compressed) {
+    _compressed->biome = chunkData.biome;
+    for (int s = 0; s < chunkSections; s++) terrainSections[s].Compress(&_compressed->sections[s]);
+}
+
+/*
+ * Restores compressed terrain in place of generating the chunk. Must only be used on a chunk which has not been
+ * generated, as the block planes are expected to be empty.
+ */
+
+void Chunk::Decompress(const CompressedChunk& _compressed) {
+    std::unique_lock lock(terrainMutex);
+    chunkData.biome = _compressed.biome;
+
+    for (int s = 0; s < chunkSections; s++) {
+        const CompressedSection& section = _compressed.sections[s];
+        terrainSections[s].Decompress(section);
+
+        // Every block of a run is in the same block planes
+        int blockIndex = 0;
+        for (uint32_t run : section.runs) {
+            BlockStateID blockState = section.palette[run >> 16];
+            int runLength = int(run & 0xFFFF) + 1;
+
+            for (int p = 0; p < nBlockPlanes; p++) {
+                if (!PlaneIncludes((BLOCKPLANE)p, blockState)) continue;
+
+                for (int i = blockIndex; i < blockIndex + runLength; i++) {
+                    int y = s * sectionSize + i / chunkArea;
+                    std::atomic_ref<uint64_t> word(blockPlanes[p][i % chunkArea][y / 64]);
+                    word.fetch_or(uint64_t(1) << (y % 64), std::memory_order_relaxed);
+                }
+            }
+
+            blockIndex += runLength;
+        }
+    }
+
+    for (int x = 0; x < chunkSize; x++) {
+        for (int z = 0; z < chunkSize; z++) UpdateColumnHeights(x, z);
+    }
+    terrainVersion.fetch_add(1, std::memory_order_release);
+    lock.unlock();
+
+    MarkForMeshUpdates();
+    generationStarted = true;
+    generated = true;
+}
+
+size_t CompressedChunk::GetMemoryUsage() const {
+    size_t bytes = sizeof(CompressedChunk);
+    for (const auto& section : sections) {
+        bytes += section.palette.capacity() * sizeof(BlockStateID);
+        bytes += section.runs.capacity() * sizeof(uint32_t);
+        bytes += section.uniqueAttributes.capacity() * sizeof(std::pair<uint16_t, BlockAttributes>);
+    }
+
+    return bytes;
+}
+
+
+
 /*
  * Generates the chunk terrain and the meshes of the chunk
  */
@@ -420,6 +671,9 @@ void Chunk::CreateTerrain() {
                 int blockDensity = World::GenerateCaveChambers(blockPos, hmTopLevel, cavernosity, hollowness);
                 generatingBlockData = BlockType{(blockDensity < 0 ? AIR : STONE), 0};
 
+                // Terrain starts as air, so caves do not need setting
+                if (generatingBlockData.blockID == AIR) continue;
+
                 SetChunkBlockAtPosition({x, y, z}, generatingBlockData);
             }
         }
@@ -441,38 +695,38 @@ void Chunk::PaintTerrain() {
             int maxY = std::max((int)hmTopLevel + 1, WATERLEVEL + 1);
             for (int y = 0; y < maxY; y++) {
 
+                // Skip sections of air which are below the toplevel, as they are entirely cave
+                int sectionTop = (y / sectionSize + 1) * sectionSize - 1;
+                if (y % sectionSize == 0 && (float)sectionTop <= hmTopLevel && terrainSections[y / sectionSize].IsEmpty()) {
+                    y = sectionTop;
+                    continue;
+                }
+
                 // If the Block is air and below toplevel, then a cave has been generated.
-                BlockType generatedSolid = GetChunkBlockAtPosition({x,y,z}).type;
-                if (generatedSolid == BlockType{AIR, 0} && (float)y <= hmTopLevel) {
+                BlockStateID generatedState = GetChunkBlockStateAtPosition({x,y,z});
+                if (generatedState == airState && (float)y <= hmTopLevel) {
                     continue; // next y
                 }
 
                 // Generate Block for position
                 glm::vec3 blockPos = glm::vec3(x, y, z) + (chunkIndex * (float)chunkSize);
                 BlockType generatingBlockData = chunkData.biome->GetBlockType(hmTopLevel, blockPos.y);
-                Block generatingBlock = GetBlockFromData(generatingBlockData);
+                BlockStateID generatingState = blockRegistry->GetStateID(generatingBlockData);
 
                 // If a block has already been generated for this position and has higher gen priority than the current
                 // block attempting to generate, then ignore new gen attempt. Equivalent gen = newest overwrite
 
-                BlockType generatedType = GetChunkBlockAtPosition({x,y,z}).type;
-                if (generatedType != BlockType{AIR, 0}) {
-                    Block generatedBlock = GetBlockFromData(generatedType);
-                    GLbyte generatedPriority = generatedBlock.GetSharedAttribute(BLOCKATTRIBUTE::GENERATIONPRIORITY);
-                    GLbyte generatingPriority = generatingBlock.GetSharedAttribute(BLOCKATTRIBUTE::GENERATIONPRIORITY);
+                if (generatedState != airState) {
+                    GLbyte generatedPriority = blockRegistry->GetGenerationPriority(generatedState);
+                    GLbyte generatingPriority = blockRegistry->GetGenerationPriority(generatingState);
 
                     if (generatedPriority > generatingPriority) continue;
                 }
 
-                // Set block and make a new unique blockptr if required
+                // Set block and its rotations and offsets, which are seeded from the block's position
                 SetChunkBlockAtPosition({x, y, z}, generatingBlockData);
-
-                // Generate Unique Block Data
-                BlockAttributes blockAttributes;
-                blockAttributes.halfRightRotations = generatingBlock.GetRandomRotation();
-                blockAttributes.topFaceDirection = generatingBlock.GetRandomTopFaceDirection();
-                blockAttributes.subBlockOffset = generatingBlock.GetRandomSubOffset(blockPos);
-                SetChunkBlockAttributesAtPosition({x,y,z}, blockAttributes);
+                const Block& generatingBlock = blockRegistry->GetBlock(generatingState);
+                SetChunkBlockAttributesAtPosition({x, y, z}, generatingBlock.GetGeneratedAttributes(blockPos));
             }
         }
     }
@@ -488,9 +742,11 @@ void Chunk::PaintTerrain() {
 void Chunk::SurfaceDecorations() {
     for (int x = 0; x < chunkSize; x++) {
         for (int z = 0; z < chunkSize; z++) {
-            glm::vec3 blockPos = {x, chunkData.heightMap[x + z * chunkSize], z};
+            // Only plant on grass/dirt variants which are the top block of their column
+            int columnHeight = GetColumnHeight(HIGHEST_BLOCK, x, z);
+            if (columnHeight < 0) continue;
 
-            // Only plant on grass/dirt variants
+            glm::vec3 blockPos = {x, columnHeight, z};
             ChunkDataTypes::ChunkBlock rootBlock = GetBlockAtPosition(blockPos);
             if (rootBlock.type.blockID != GRASS) continue;
 
@@ -504,21 +760,22 @@ void Chunk::SurfaceDecorations() {
             else if ((int)foliageType < (int)Biome::FOLIAGE::STRUCTURE_TYPE) {
                 int plantHeight = 0;
                 BlockType plantBlockType = chunkData.biome->BuildFoliage(foliageType, plantDensity, &plantHeight);
-                Block plantBlock = GetBlockFromData(plantBlockType);
 
-                glm::i8vec3 subOffset = plantBlock.GetRandomSubOffset(blockPos);
+                // The whole plant shares the sub block offset of its root position
+                const Block& plantBlock = blockRegistry->GetBlock(blockRegistry->GetStateID(plantBlockType));
+                BlockAttributes blockAttributes;
+                blockAttributes.subBlockOffset = plantBlock.GetRandomSubOffset(blockPos);
 
                 for (int i = 1; i <= plantHeight; i++) {
                     SetBlockAtPosition(blockPos + (dirTop * (float) i), plantBlockType);
-
-                    BlockAttributes blockAttributes;
-                    blockAttributes.subBlockOffset = subOffset;
                     SetBlockAttributesAtPosition(blockPos + (dirTop * (float) i), blockAttributes);
                 }
             }
 
             // Large Plant Structure
             else {
+                // The biome holds the structure being built, which is shared by every chunk of the biome
+                auto structureLock = chunkData.biome->LockStructure();
                 chunkData.biome->LoadStructure((Biome::STRUCTURES)foliageType);
                 glm::vec3 plantPos = blockPos + dirTop;
 
@@ -537,20 +794,20 @@ void Chunk::SurfaceDecorations() {
                         doonce = true;
                     }
 
-                    ChunkDataTypes::ChunkBlock loadedBlockType = GetBlockAtPosition(foliageBlock.blockPos + plantPos);
-                    Block loadingBlock = GetBlockFromData(foliageBlock.blockType);
+                    BlockStateID loadedState = GetBlockStateAtPosition(foliageBlock.blockPos + plantPos);
+                    BlockStateID loadingState = blockRegistry->GetStateID(foliageBlock.blockType);
 
                     // Ensure vegetation can overwrite any current blocks in that position before placing
-                    if (loadedBlockType.type != BlockType{AIR, 0}) {
-                        Block generatedBlock = GetBlockFromData(loadedBlockType.type);
-                        GLbyte generatedPriority = generatedBlock.GetSharedAttribute(BLOCKATTRIBUTE::GENERATIONPRIORITY);
-                        GLbyte generatingPriority = loadingBlock.GetSharedAttribute(BLOCKATTRIBUTE::GENERATIONPRIORITY);
+                    if (loadedState != airState) {
+                        GLbyte generatedPriority = blockRegistry->GetGenerationPriority(loadedState);
+                        GLbyte generatingPriority = blockRegistry->GetGenerationPriority(loadingState);
 
                         if (generatedPriority > generatingPriority) continue;
                     }
 
                     SetBlockAtPosition(foliageBlock.blockPos + plantPos, foliageBlock.blockType);
 
+                    const Block& loadingBlock = blockRegistry->GetBlock(loadingState);
                     BlockAttributes blockAttributes;
                     blockAttributes.subBlockOffset = loadingBlock.GetRandomSubOffset(foliageBlock.blockPos + plantPos);
                     SetBlockAttributesAtPosition(foliageBlock.blockPos + plantPos, blockAttributes);
@@ -568,9 +825,10 @@ void Chunk::SurfaceDecorations() {
 bool Chunk::RegionGenerated() const {
     auto adjacentDirs = { dirFront, dirLeft, dirBack, dirRight };
 
+    auto readGuard = world->ReadChunks();
     bool adjGenerated = true;
     for (const auto& adjDir : adjacentDirs) {
-        auto adjChunk = world->GetChunkAtIndex(chunkIndex + adjDir);
+        Chunk* adjChunk = GetAdjacentChunk((int)adjDir.x, (int)adjDir.z);
         if (adjChunk == nullptr || !adjChunk->Generated()) {
             adjGenerated = false;
             break;
@@ -604,27 +862,13 @@ void Chunk::PlaceBlockAtPosition(glm::vec3 _blockPos, BlockType _blockType) {
     std::array<glm::vec3, 7> blockPositions {_blockPos, _blockPos + dirTop, _blockPos + dirBottom, _blockPos + dirLeft,
                                              _blockPos + dirRight, _blockPos + dirFront, _blockPos + dirBack};
 
-    // Mark original block's mesh for recreation and add original block mesh's chunk to list
-    ChunkDataTypes::ChunkBlock originalBlock = blockChunk->GetChunkBlockAtPosition(_blockPos);
-    MaterialMesh* blockMesh = blockChunk->GetMeshFromBlock(originalBlock.type);
-    if (blockMesh != nullptr) {
-        blockMesh->MarkOld();
-    }
-
     // Place new block at position
     blockChunk->SetChunkBlockAtPosition(_blockPos, _blockType);
-    blockChunk->MarkForMeshUpdates();
 
+    // Only the sections of the placed block and the adjacent blocks need their meshes recreating
     for (auto& blockPosition : blockPositions) {
         auto chunkAtPosition = blockChunk->GetChunkAtBlockPos(blockPosition);
-        if (chunkAtPosition != nullptr) {
-            chunkAtPosition->MarkForMeshUpdates();
-
-            // mark new block's mesh and meshes of adjacent blocks for updates
-            ChunkDataTypes::ChunkBlock chunkBlock = chunkAtPosition->GetBlockAtPosition(blockPosition);
-            MaterialMesh* chunkMesh = chunkAtPosition->GetMeshFromBlock(chunkBlock.type);
-            if (chunkMesh != nullptr) chunkMesh->MarkOld();
-        }
+        if (chunkAtPosition != nullptr) chunkAtPosition->MarkSectionsForMeshUpdates((int)blockPosition.y);
     }
 }
 
@@ -636,11 +880,75 @@ void Chunk::PlaceBlockAtPosition(glm::vec3 _blockPos, BlockType _blockType) {
 
 void Chunk::SetChunkBlockAtPosition(const glm::vec3 &_blockPos, const BlockType& _blockType) {
     // Set block and clear attributes
-    std::unique_lock lockGuard(terrainLayers[(int)_blockPos.y].layerLock);
-    terrainLayers[(int)_blockPos.y].blockLayer[(int)_blockPos.x + (int)_blockPos.z * chunkSize] = {_blockType, {}};
+    int y = (int)_blockPos.y;
+    int blockIndex = ChunkSection::GetBlockIndex((int)_blockPos.x, y % sectionSize, (int)_blockPos.z);
+    BlockStateID blockState = blockRegistry->GetStateID(_blockType);
+
+    // Block, block planes and column heights are updated together so that concurrent writes to a column cannot interleave
+    std::unique_lock lock(terrainMutex);
+    terrainSections[y / sectionSize].SetBlockState(blockIndex, blockState);
+    UpdateBlockPlanes((int)_blockPos.x, y, (int)_blockPos.z, blockState);
+    UpdateColumnHeights((int)_blockPos.x, (int)_blockPos.z);
+    terrainVersion.fetch_add(1, std::memory_order_release);
+}
+
+/*
+ * Returns true if the block state has its bit set in the given block plane
+ */
+
+bool Chunk::PlaneIncludes(BLOCKPLANE _plane, BlockStateID _blockState) {
+    switch (_plane) {
+        case PLANE_OCCUPIED:
+            return _blockState != airState;
+
+        case PLANE_OPAQUE:
+            return _blockState != airState && !blockRegistry->HasFlag(_blockState, FLAG_TRANSPARENT);
 
-    if (uniqueBlockMap[_blockType] == nullptr) {
-        uniqueBlockMap[_blockType] = CreateBlock(_blockType);
+        case PLANE_SOLID:
+            return blockRegistry->HasFlag(_blockState, FLAG_ENTITYCOLLISIONSOLID);
+
+        case PLANE_LIQUID:
+            return blockRegistry->HasFlag(_blockState, FLAG_LIQUID);
+
+        default:
+            return false;
+    }
+}
+
+/*
+ * Sets or clears the bit of the block at the given position in each block plane. Words are written atomically as
+ * readers do not hold the terrain lock. Must be called whilst holding the terrain lock.
+ */
+
+void Chunk::UpdateBlockPlanes(int _x, int _y, int _z, BlockStateID _blockState) {
+    int column = _x + _z * chunkSize;
+    uint64_t bit = uint64_t(1) << (_y % 64);
+
+    for (int p = 0; p < nBlockPlanes; p++) {
+        std::atomic_ref<uint64_t> word(blockPlanes[p][column][_y / 64]);
+        uint64_t wordValue = word.load(std::memory_order_relaxed);
+
+        if (PlaneIncludes((BLOCKPLANE)p, _blockState)) word.store(wordValue | bit, std::memory_order_relaxed);
+        else word.store(wordValue & ~bit, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Recalculates the column heightmaps from the highest set bit of their block plane. Must be called whilst holding the
+ * terrain lock.
+ */
+
+void Chunk::UpdateColumnHeights(int _x, int _z) {
+    static const std::array<BLOCKPLANE, nHeightMaps> heightMapPlanes { PLANE_OCCUPIED, PLANE_SOLID, PLANE_OPAQUE };
+
+    for (int h = 0; h < nHeightMaps; h++) {
+        int height = -1;
+        for (int w = chunkColumnWords - 1; w >= 0 && height == -1; w--) {
+            uint64_t word = GetColumnPlaneWord(heightMapPlanes[h], _x, _z, w);
+            if (word != 0) height = w * 64 + 63 - std::countl_zero(word);
+        }
+
+        columnHeights[h][_x + _z * chunkSize].store((int16_t)height, std::memory_order_relaxed);
     }
 }
 
@@ -649,7 +957,8 @@ void Chunk::SetChunkBlockAtPosition(const glm::vec3 &_blockPos, const BlockType&
  */
 
 void Chunk::SetBlockAtPosition(glm::vec3 _blockPos, const BlockType& _blockType) const {
-    auto blockChunk = GetChunkAtBlockPos(_blockPos);
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
     if (blockChunk == nullptr) return;
 
     blockChunk->SetChunkBlockAtPosition(_blockPos, _blockType);
@@ -662,28 +971,72 @@ void Chunk::SetBlockAtPosition(glm::vec3 _blockPos, const BlockType& _blockType)
  */
 
 ChunkDataTypes::ChunkBlock Chunk::GetChunkBlockAtPosition(const glm::vec3& _blockPos) {
-    std::unique_lock lockGuard(terrainLayers[(int)_blockPos.y].layerLock);
-    return terrainLayers[(int)_blockPos.y].blockLayer[(int)_blockPos.x + (int)_blockPos.z * chunkSize];
+    int y = (int)_blockPos.y;
+    int blockIndex = ChunkSection::GetBlockIndex((int)_blockPos.x, y % sectionSize, (int)_blockPos.z);
+    ChunkSection& section = terrainSections[y / sectionSize];
+
+    // Blocks without unique attributes keep the default attributes
+    ChunkDataTypes::ChunkBlock chunkBlock {blockRegistry->GetBlockType(section.GetBlockState(blockIndex))};
+    if (!section.GetUniqueAttributes(blockIndex, &chunkBlock.attributes)) chunkBlock.attributes = {};
+
+    return chunkBlock;
 }
 
 
 BlockAttributes Chunk::GetChunkBlockAttributesAtPosition(const glm::vec3 &_blockPos) {
-    std::unique_lock lockGuard(terrainLayers[(int)_blockPos.y].layerLock);
-    return terrainLayers[(int)_blockPos.y].blockLayer[(int)_blockPos.x + (int)_blockPos.z * chunkSize].attributes;
+    return GetChunkBlockAtPosition(_blockPos).attributes;
 }
 
+/*
+ * Sets the attributes of the block at the given position. Only attributes which differ from the default attributes are
+ * stored in the chunk's sections.
+ */
+
 void Chunk::SetChunkBlockAttributesAtPosition(const glm::vec3 &_blockPos, const BlockAttributes &_attributes) {
-    std::unique_lock lockGuard(terrainLayers[(int)_blockPos.y].layerLock);
-    terrainLayers[(int)_blockPos.y].blockLayer[(int)_blockPos.x + (int)_blockPos.z * chunkSize].attributes = _attributes;
+    int y = (int)_blockPos.y;
+    int blockIndex = ChunkSection::GetBlockIndex((int)_blockPos.x, y % sectionSize, (int)_blockPos.z);
+    ChunkSection& section = terrainSections[y / sectionSize];
+
+    if (_attributes == BlockAttributes{}) section.ClearUniqueAttributes(blockIndex);
+    else section.SetUniqueAttributes(blockIndex, _attributes);
+}
+
+
+/*
+ * Fetches the block state at position. Assumes provided position values are within 0 - 15.
+ */
+
+BlockStateID Chunk::GetChunkBlockStateAtPosition(const glm::vec3 &_blockPos) {
+    int y = (int)_blockPos.y;
+    int blockIndex = ChunkSection::GetBlockIndex((int)_blockPos.x, y % sectionSize, (int)_blockPos.z);
+    return terrainSections[y / sectionSize].GetBlockState(blockIndex);
 }
 
+BlockStateID Chunk::GetChunkBlockState(const LocalBlockPos& _localPos) const {
+    int blockIndex = ChunkSection::GetBlockIndex(_localPos.x, _localPos.y % sectionSize, _localPos.z);
+    return terrainSections[_localPos.y / sectionSize].GetBlockState(blockIndex);
+}
+
+/*
+ * Obtains the chunk that the provided position is within, and gets the block state in that chunk. Positions outside of
+ * the loaded world are air.
+ */
+
+BlockStateID Chunk::GetBlockStateAtPosition(glm::vec3 _blockPos) const {
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
+    if (blockChunk == nullptr) return airState;
+
+    return blockChunk->GetChunkBlockStateAtPosition(_blockPos);
+}
 
 /*
  * Obtains the chunk that the provided position is within, and gets the block in that chunk
  */
 
 ChunkDataTypes::ChunkBlock Chunk::GetBlockAtPosition(glm::vec3 _blockPos) const {
-    auto blockChunk = GetChunkAtBlockPos(_blockPos);
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
     if (blockChunk == nullptr) return {};
 
     return blockChunk->GetChunkBlockAtPosition(_blockPos);
@@ -691,30 +1044,80 @@ ChunkDataTypes::ChunkBlock Chunk::GetBlockAtPosition(glm::vec3 _blockPos) const
 
 
 void Chunk::SetBlockAttributesAtPosition(glm::vec3 _blockPos, const BlockAttributes& _attributes) const {
-    auto blockChunk = GetChunkAtBlockPos(_blockPos);
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
     if (blockChunk == nullptr) return;
 
     blockChunk->SetChunkBlockAttributesAtPosition(_blockPos, _attributes);
 }
 
 BlockAttributes Chunk::GetBlockAttributesAtPosition(glm::vec3 _blockPos) const {
-    auto blockChunk = GetChunkAtBlockPos(_blockPos);
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
     if (blockChunk == nullptr) return {};
 
     return blockChunk->GetChunkBlockAttributesAtPosition(_blockPos);
 }
 
 /*
- * Returns a pointer to a unique block instance in the chunk. If the provided data does not correlate to a unique block
- * then a new block is created and added, and a pointer to that returned.
+ * Returns the shared block instance of the block type from the block registry
  */
 
-Block& Chunk::GetBlockFromData(const BlockType& _blockType) {
-    if (uniqueBlockMap[_blockType] == nullptr) {
-        uniqueBlockMap[_blockType] = CreateBlock(_blockType);
-    }
+const Block& Chunk::GetBlockFromData(const BlockType& _blockType) {
+    return blockRegistry->GetBlock(blockRegistry->GetStateID(_blockType));
+}
+
+
+
+/*
+ * Returns the 64 blocks of the column in the block plane starting at height _word * 64. Assumes provided position
+ * values are within 0 - 15.
+ */
+
+uint64_t Chunk::GetColumnPlaneWord(BLOCKPLANE _plane, int _x, int _z, int _word) const {
+    auto& word = const_cast<uint64_t&>(blockPlanes[_plane][_x + _z * chunkSize][_word]);
+    return std::atomic_ref<uint64_t>(word).load(std::memory_order_relaxed);
+}
 
-    return *uniqueBlockMap[_blockType];
+bool Chunk::BlockInPlane(BLOCKPLANE _plane, int _x, int _y, int _z) const {
+    return (GetColumnPlaneWord(_plane, _x, _z, _y / 64) >> (_y % 64)) & 1;
+}
+
+/*
+ * Obtains the chunk that the provided position is within, and checks the block plane in that chunk. Positions outside
+ * of the loaded world are not in any plane.
+ */
+
+bool Chunk::BlockInPlaneAtPosition(BLOCKPLANE _plane, glm::vec3 _blockPos) const {
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
+    if (blockChunk == nullptr) return false;
+
+    return blockChunk->BlockInPlane(_plane, (int)_blockPos.x, (int)_blockPos.y, (int)_blockPos.z);
+}
+
+/*
+ * Returns the y of the highest block of the heightmap within the column, or -1 if there is no such block. Assumes
+ * provided position values are within 0 - 15.
+ */
+
+int Chunk::GetColumnHeight(HEIGHTMAP _heightMap, int _x, int _z) const {
+    return columnHeights[_heightMap][_x + _z * chunkSize].load(std::memory_order_relaxed);
+}
+
+/*
+ * Obtains the chunk that the provided position is within, and gets the column height in that chunk. Positions outside
+ * of the loaded world return -1.
+ */
+
+int Chunk::GetColumnHeightAtPosition(HEIGHTMAP _heightMap, glm::vec3 _blockPos) const {
+    _blockPos.y = 0;
+
+    auto readGuard = world->ReadChunks();
+    Chunk* blockChunk = BorrowChunkAtBlockPos(_blockPos);
+    if (blockChunk == nullptr) return -1;
+
+    return blockChunk->GetColumnHeight(_heightMap, (int)_blockPos.x, (int)_blockPos.z);
 }
 
 
@@ -724,13 +1127,12 @@ Block& Chunk::GetBlockFromData(const BlockType& _blockType) {
  */
 
 float Chunk::GetTopLevelAtPosition(glm::vec3 _blockPos, float _radius) {
-    ChunkDataTypes::ChunkBlock playerBlock = GetBlockAtPosition(_blockPos + dirTop);
-    Block playerBlockPtr = GetBlockFromData(playerBlock.type);
-    if (playerBlockPtr.GetSharedAttribute(BLOCKATTRIBUTE::ENTITYCOLLISIONSOLID) != 0) {
+    if (BlockInPlaneAtPosition(PLANE_SOLID, _blockPos + dirTop)) {
         return GetTopLevelAtPosition(_blockPos + dirTop, _radius);
     }
 
     float topLevel = -20;
+    auto readGuard = world->ReadChunks();
 
     // if position y is 0.8 or above, round to ciel
     float y = (_blockPos.y - floorf(_blockPos.y) >= 0.8f) ? roundf(_blockPos.y) : floorf(_blockPos.y);
@@ -740,12 +1142,15 @@ float Chunk::GetTopLevelAtPosition(glm::vec3 _blockPos, float _radius) {
         for (int z = int(100.0 * (_blockPos.z - _radius)); z <= int(100.0 * (_blockPos.z + _radius)); z += int(100.0 * _radius)) {
             // Convert back to float position of block relative to chunk
             glm::vec3 position{x/100.0, y, z/100.0};
-            ChunkDataTypes::ChunkBlock block = GetBlockAtPosition(position);
-            Block blockPtr = GetBlockFromData(block.type);
+            Chunk* positionChunk = BorrowChunkAtBlockPos(position);
+            if (positionChunk == nullptr) continue;
+
+            // Nothing above the column's highest solid block can be stood on
+            int columnHeight = positionChunk->GetColumnHeight(HIGHEST_SOLID, (int)position.x, (int)position.z);
+            if ((int)position.y > columnHeight) continue;
 
             // If no block found / air, or if it is a liquid (ie: water) / non-solid then do not apply topLevel
-            if (block.type.blockID == AIR) continue;
-            if (blockPtr.GetSharedAttribute(BLOCKATTRIBUTE::ENTITYCOLLISIONSOLID) == 0) continue;
+            if (!positionChunk->BlockInPlane(PLANE_SOLID, (int)position.x, (int)position.y, (int)position.z)) continue;
 
             // blockHeight + y in chunk + chunkHeight
             float blockTL = 1.0f + y + chunkIndex.y * (float)chunkSize;
@@ -770,16 +1175,15 @@ float Chunk::GetDistanceToBlockFace(glm::vec3 _blockPos, glm::vec3 _direction, f
     // 2 blocks (to prevent stop-starting player movement if they move faster than 1 block/second)
     // also applies for air or liquid blocks
 
-    ChunkDataTypes::ChunkBlock block = GetBlockAtPosition(_blockPos + _direction);
-    Block blockPtr = GetBlockFromData(block.type);
-
-    if (block.type.blockID == AIR ||
-            blockPtr.GetSharedAttribute(BLOCKATTRIBUTE::ENTITYCOLLISIONSOLID) == 0) {
+    if (!BlockInPlaneAtPosition(PLANE_SOLID, _blockPos + _direction)) {
         if (_direction.x != 0) return floorf(_blockPos.x) + _direction.x * 2.0f;
         if (_direction.y != 0) return floorf(_blockPos.y) + _direction.y * 2.0f;
         if (_direction.z != 0) return floorf(_blockPos.z) + _direction.z * 2.0f;
     }
 
+    ChunkDataTypes::ChunkBlock block = GetBlockAtPosition(_blockPos + _direction);
+    const Block& blockPtr = GetBlockFromData(block.type);
+
     BLOCKFACE face {};
     std::vector<UniqueVertex> faceVerticies {};
     float minZ {0}, maxZ {0};
@@ -852,4 +1256,60 @@ std::shared_ptr<Chunk> Chunk::GetChunkAtBlockPos(glm::vec3& _blockPos) const {
         chunk = nullptr;
 
     return chunk;
-}
\ No newline at end of file
+}
+
+/*
+ * As GetChunkAtBlockPos, but borrows the chunk rather than taking a reference to it. The caller must hold a
+ * ChunkReadGuard (see World::ReadChunks) for as long as the returned chunk is used. Positions within the adjacent
+ * chunks are resolved through the adjacent chunk links, and only positions further away look up the world.
+ */
+
+Chunk* Chunk::BorrowChunkAtBlockPos(glm::vec3& _blockPos) const {
+    int x = (int)floorf(_blockPos.x);
+    int z = (int)floorf(_blockPos.z);
+    int localX = x, localZ = z;
+
+    Chunk* chunk = BorrowChunkAtLocalPos(localX, (int)floorf(_blockPos.y), localZ);
+    if (chunk != nullptr) {
+        _blockPos.x += float(localX - x);
+        _blockPos.z += float(localZ - z);
+    }
+
+    return chunk;
+}
+
+/*
+ * As BorrowChunkAtBlockPos, for integer positions. _x and _z are updated to be within the returned chunk.
+ */
+
+Chunk* Chunk::BorrowChunkAtLocalPos(int& _x, int _y, int& _z) const {
+    if (_y < 0 || _y >= chunkHeight) return nullptr;
+
+    int dx = _x >> chunkSizeBits;
+    int dz = _z >> chunkSizeBits;
+    if (dx == 0 && dz == 0) return const_cast<Chunk*>(this);
+
+    _x &= chunkSize - 1;
+    _z &= chunkSize - 1;
+
+    if (std::abs(dx) <= 1 && std::abs(dz) <= 1) return GetAdjacentChunk(dx, dz);
+    return world->BorrowChunkAtIndex(chunkPos + ChunkPos{dx, dz});
+}
+
+/*
+ * Adjacent chunk links, set and cleared by the world as chunks are created and unloaded. Clearing only removes the
+ * link if it is still to the given chunk, so that a newer chunk linked in the meantime is kept.
+ */
+
+Chunk* Chunk::GetAdjacentChunk(int _dx, int _dz) const {
+    if (_dx == 0 && _dz == 0) return const_cast<Chunk*>(this);
+    return adjacentChunks[GetAdjacentIndex(_dx, _dz)].load(std::memory_order_acquire);
+}
+
+void Chunk::SetAdjacentChunk(int _dx, int _dz, Chunk* _chunk) {
+    adjacentChunks[GetAdjacentIndex(_dx, _dz)].store(_chunk, std::memory_order_seq_cst);
+}
+
+void Chunk::ClearAdjacentChunk(int _dx, int _dz, Chunk* _chunk) {
+    adjacentChunks[GetAdjacentIndex(_dx, _dz)].compare_exchange_strong(_chunk, nullptr, std::memory_order_seq_cst);
+}
@@ -9,11 +9,15 @@
 #include <unordered_map>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 #include "../../BlockModels/MaterialMesh.h"
 #include "../../Player/Camera.h"
 #include "../WorldGenConsts.h"
+#include "../WorldCoords.h"
 #include "../Biomes/Biome.h"
+#include "ChunkSection.h"
+#include "ChunkSnapshot.h"
 
 // CHUNK TYPEDEFS
 namespace ChunkDataTypes {
@@ -22,16 +26,31 @@ namespace ChunkDataTypes {
         BlockAttributes attributes;
     };
 
-    struct LockableTerrainLayer {
-        std::array<ChunkBlock, chunkArea> blockLayer;
-        std::mutex layerLock;
-    };
-
-    typedef std::array<LockableTerrainLayer, chunkHeight> TerrainArray;
+    typedef std::array<ChunkSection, chunkSections> TerrainArray;
     typedef std::array<float, chunkArea> DataMap;
     typedef std::array<GLbyte, chunkArea> ByteMap;
 }
 
+/*
+ * The live per-column heightmaps maintained by each chunk. Each stores the y of the highest block in the column which
+ * is not air, is solid to entities, or is opaque respectively, or -1 if the column has no such block.
+ */
+
+enum HEIGHTMAP : int {
+    HIGHEST_BLOCK, HIGHEST_SOLID, HIGHEST_OPAQUE, nHeightMaps
+};
+
+/*
+ * The packed block bitmasks maintained by each chunk, with one bit per block which is set if the block is not air, is
+ * opaque, is solid to entities, or is a liquid respectively. Each column of the chunk is stored as chunkColumnWords
+ * 64-bit words, where bit (y % 64) of word (y / 64) is the block at height y, so 64 blocks of a column can be tested
+ * with a single word.
+ */
+
+enum BLOCKPLANE : int {
+    PLANE_OCCUPIED, PLANE_OPAQUE, PLANE_SOLID, PLANE_LIQUID, nBlockPlanes
+};
+
 /*
  * Simple data struct used to hold various maps of the chunk's blocks and biome information.
  */
@@ -45,11 +64,22 @@ struct ChunkData {
     ChunkDataTypes::DataMap plantMap {};
 };
 
+/*
+ * A generated chunk's terrain compressed for the chunk cache (see ChunkCache)
+ */
+
+struct CompressedChunk {
+    Biome* biome {};
+    std::array<CompressedSection, chunkSections> sections {};
+
+    [[nodiscard]] size_t GetMemoryUsage() const;
+};
+
 /*
  * Houses a 3D array of blocks, of cubic size 16x16x16 (chunkSize^3). Resonsible for generating blocks from a given set
  * of maps (see ChunkData) and then generating biome-specific structures. Chunk also incorporates pointers to the
- * surrounding 10 adjacent chunks (diagonal top/bottoms not included) which can be used for mesh creation and various
- * block updates / interactions.
+ * 8 surrounding chunks, held in a 3x3 grid around the chunk whose centre slot is unused, maintained by the world as
+ * chunks are created and unloaded, which are used for mesh creation and various block updates / interactions.
  */
 
 class Chunk {
@@ -59,45 +89,67 @@ class Chunk {
         Transformation cullingTransformation {};
         Transformation displayTransformation {};
         bool inCamera = true;
-        bool needsMeshUpdates = false;
-        bool unboundMeshChanges = false;
+        std::atomic<bool> needsMeshUpdates = false;
+        std::atomic<uint32_t> meshUpdateSections = 0; // bit per section which must be meshed again
+        static_assert(chunkSections <= 32);
+        std::atomic<bool> unboundMeshChanges = false;
 
         // Chunk Terrain and Block Data
-        std::unordered_map<BlockType, std::unique_ptr<Block>> uniqueBlockMap {};
-        std::unordered_map<BlockType, std::unique_ptr<MaterialMesh>> uniqueMeshMap {};
+        std::unordered_map<BlockStateID, std::unique_ptr<MaterialMesh>> uniqueMeshMap {};
         std::mutex meshMutex;
+        std::mutex meshingMutex; // only one job may mesh the chunk at once
         std::mutex terrainMutex;
-        ChunkDataTypes::TerrainArray terrainLayers {};
-        bool generated = false;
-
-        // Unique ChunkData and the adjacent Chunk pointers
+        ChunkDataTypes::TerrainArray terrainSections {};
+        std::atomic<uint32_t> terrainVersion = 0; // incremented by every block change
+        std::array<std::array<std::atomic<int16_t>, chunkArea>, nHeightMaps> columnHeights {};
+        std::array<std::array<std::array<uint64_t, chunkColumnWords>, chunkArea>, nBlockPlanes> blockPlanes {};
+        std::atomic<bool> generated = false;
+        std::atomic<bool> generationStarted = false; // only one job may generate the chunk
+
+        // Unique ChunkData and the adjacent Chunk pointers. Adjacent chunks are borrowed (see World::ReadChunks)
         ChunkData chunkData;
         glm::vec3 chunkIndex {0, 0, 0};
+        ChunkPos chunkPos {};
+        std::array<std::atomic<Chunk*>, 9> adjacentChunks {}; // 3x3 by offset (see GetAdjacentIndex), centre unused
 
         // Private functions for getting/setting blocks which non-chunks shouldn't access
         [[nodiscard]] ChunkDataTypes::ChunkBlock GetChunkBlockAtPosition(const glm::vec3& _blockPos);
+        [[nodiscard]] BlockStateID GetChunkBlockStateAtPosition(const glm::vec3& _blockPos);
         void SetChunkBlockAtPosition(const glm::vec3& _blockPos, const BlockType& _blockType);
         [[nodiscard]] BlockAttributes GetChunkBlockAttributesAtPosition(const glm::vec3& _blockPos);
         void SetChunkBlockAttributesAtPosition(const glm::vec3& _blockPos, const BlockAttributes& _attributes);
 
+        // Block plane and column heightmap maintenance
+        [[nodiscard]] static bool PlaneIncludes(BLOCKPLANE _plane, BlockStateID _blockState);
+        void UpdateBlockPlanes(int _x, int _y, int _z, BlockStateID _blockState);
+        void UpdateColumnHeights(int _x, int _z);
+
     public:
         Chunk(const glm::vec3& _chunkPosition, ChunkData _chunkData);
         ~Chunk();
+        void Reset(const glm::vec3& _chunkPosition, const ChunkData& _chunkData);
 
         // Chunk Display
         void DisplaySolid();
         void DisplayTransparent();
 
         // Chunk Block Meshes Creation / Updating
-        void UpdateBlockMesh(Block* _meshBlock);
-        void CreateChunkMeshes();
-        void CalculateOcclusion(std::vector<UniqueVertex>& _verticies, Block& _block, const glm::vec3& _position);
+        void UpdateBlockMesh(const Block* _meshBlock);
+        [[nodiscard]] bool CreateChunkMeshes();
+        void CreateSnapshot(ChunkSnapshot* _snapshot, int _minSection = 0, int _maxSection = chunkSections - 1);
+        void CopyToSnapshot(ChunkSnapshot* _snapshot, int _minX, int _maxX, int _minZ, int _maxZ, int _offsetX,
+                            int _offsetZ, int _minSection, int _maxSection);
+        void CalculateOcclusion(std::vector<UniqueVertex>& _verticies, const ChunkSnapshot& _snapshot,
+                                BlockStateID _blockState, const glm::vec3& _position);
         [[nodiscard]] std::vector<BLOCKFACE> GetHiddenFaces(glm::vec3 _blockPos);
-        [[nodiscard]] std::vector<BLOCKFACE> GetShowingFaces(glm::vec3 _blockPos, const Block& _checkingBlock);
+        [[nodiscard]] std::vector<BLOCKFACE> GetShowingFaces(const ChunkSnapshot& _snapshot, glm::vec3 _blockPos,
+                                                             BlockStateID _checkingState);
         [[nodiscard]] MaterialMesh* GetMeshFromBlock(const BlockType& _blockType);
+        [[nodiscard]] MaterialMesh* GetMeshFromState(BlockStateID _blockState);
 
         // Mesh Processing Signals + Mesh Binding
         void MarkForMeshUpdates();
+        void MarkSectionsForMeshUpdates(int _y);
         void BindChunkMeshes();
         [[nodiscard]] bool NeedsMeshUpdates() const { return needsMeshUpdates; }
         [[nodiscard]] bool UnboundMeshChanges() const { return unboundMeshChanges; }
@@ -114,25 +166,48 @@ class Chunk {
         void PaintTerrain();
         void SurfaceDecorations();
         [[nodiscard]] bool Generated() const { return generated; }
+        [[nodiscard]] uint32_t GetTerrainVersion() const { return terrainVersion.load(std::memory_order_acquire); }
         [[nodiscard]] bool RegionGenerated() const;
 
+        // Chunk Terrain Compression
+        void Compress(CompressedChunk* _compressed);
+        void Decompress(const CompressedChunk& _compressed);
+
         // Chunk Block Interaction
         void BreakBlockAtPosition(glm::vec3 _blockPos);
         void PlaceBlockAtPosition(glm::vec3 _blockPos, BlockType _blockType);
         void SetBlockAtPosition(glm::vec3 _blockPos, const BlockType& _blockType) const;
         [[nodiscard]] ChunkDataTypes::ChunkBlock GetBlockAtPosition(glm::vec3 _blockPos) const;
+        [[nodiscard]] BlockStateID GetBlockStateAtPosition(glm::vec3 _blockPos) const;
+        [[nodiscard]] BlockStateID GetChunkBlockState(const LocalBlockPos& _localPos) const;
         void SetBlockAttributesAtPosition(glm::vec3 _blockPos, const BlockAttributes& _attributes) const;
         [[nodiscard]] BlockAttributes GetBlockAttributesAtPosition(glm::vec3 _blockPos) const;
 
+        // Block Planes and Column Heightmaps
+        [[nodiscard]] uint64_t GetColumnPlaneWord(BLOCKPLANE _plane, int _x, int _z, int _word) const;
+        [[nodiscard]] bool BlockInPlane(BLOCKPLANE _plane, int _x, int _y, int _z) const;
+        [[nodiscard]] bool BlockInPlaneAtPosition(BLOCKPLANE _plane, glm::vec3 _blockPos) const;
+        [[nodiscard]] int GetColumnHeight(HEIGHTMAP _heightMap, int _x, int _z) const;
+        [[nodiscard]] int GetColumnHeightAtPosition(HEIGHTMAP _heightMap, glm::vec3 _blockPos) const;
+
         // Chunk-Entity Collision
         [[nodiscard]] float GetTopLevelAtPosition(glm::vec3 _blockPos, float _radius) ;
         [[nodiscard]] float GetDistanceToBlockFace(glm::vec3 _blockPos, glm::vec3 _direction, float _radius) ;
 
         //
-        [[nodiscard]] Block& GetBlockFromData(const BlockType& _blockType);
+        [[nodiscard]] static const Block& GetBlockFromData(const BlockType& _blockType);
         [[nodiscard]] glm::vec3 GetIndex() const { return chunkIndex; }
         [[nodiscard]] glm::vec2 GetXZIndex() const { return {chunkIndex.x, chunkIndex.z}; }
+        [[nodiscard]] ChunkPos GetChunkPos() const { return chunkPos; }
         [[nodiscard]] std::shared_ptr<Chunk> GetChunkAtBlockPos(glm::vec3& _blockPos) const;
+        [[nodiscard]] Chunk* BorrowChunkAtBlockPos(glm::vec3& _blockPos) const;
+        [[nodiscard]] Chunk* BorrowChunkAtLocalPos(int& _x, int _y, int& _z) const;
+
+        // Adjacent Chunk Links
+        [[nodiscard]] static int GetAdjacentIndex(int _dx, int _dz) { return (_dx + 1) + (_dz + 1) * 3; }
+        [[nodiscard]] Chunk* GetAdjacentChunk(int _dx, int _dz) const;
+        void SetAdjacentChunk(int _dx, int _dz, Chunk* _chunk);
+        void ClearAdjacentChunk(int _dx, int _dz, Chunk* _chunk);
 };
 
 
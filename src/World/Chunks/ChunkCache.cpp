@@ -0,0 +1,77 @@
+#include "ChunkCache.h"
+
+ChunkCache::ChunkCache(size_t _maxBytes) : maxBytes(_maxBytes) {
+
+}
+
+
+
+/*
+ * Adds a chunk as the most recently used entry, replacing any older entry for the same position, then drops the least
+ * recently used entries until the cache is within its byte budget
+ */
+
+void ChunkCache::Insert(const ChunkPos& _chunkPos, std::unique_ptr<CompressedChunk> _chunk) {
+    size_t bytes = _chunk->GetMemoryUsage();
+
+    std::unique_lock lockGuard(cacheLock);
+
+    auto entryIter = entryMap.find(_chunkPos);
+    if (entryIter != entryMap.end()) {
+        usedBytes -= entryIter->second->bytes;
+        entries.erase(entryIter->second);
+        entryMap.erase(entryIter);
+    }
+
+    entries.push_front({_chunkPos, std::move(_chunk), bytes});
+    entryMap[_chunkPos] = entries.begin();
+    usedBytes += bytes;
+
+    while (usedBytes > maxBytes && !entries.empty()) {
+        usedBytes -= entries.back().bytes;
+        entryMap.erase(entries.back().chunkPos);
+        entries.pop_back();
+    }
+}
+
+
+
+/*
+ * Removes and returns the chunk cached for the position, or nullptr if it is not cached
+ */
+
+std::unique_ptr<CompressedChunk> ChunkCache::Take(const ChunkPos& _chunkPos) {
+    std::unique_lock lockGuard(cacheLock);
+
+    auto entryIter = entryMap.find(_chunkPos);
+    if (entryIter == entryMap.end()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    std::unique_ptr<CompressedChunk> chunk = std::move(entryIter->second->chunk);
+    usedBytes -= entryIter->second->bytes;
+    entries.erase(entryIter->second);
+    entryMap.erase(entryIter);
+
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return chunk;
+}
+
+
+
+/*
+ * Whether a chunk is cached for the position. The entry may be dropped or taken before it is used
+ */
+
+bool ChunkCache::Contains(const ChunkPos& _chunkPos) const {
+    std::unique_lock lockGuard(cacheLock);
+    return entryMap.contains(_chunkPos);
+}
+
+
+
+size_t ChunkCache::GetUsedBytes() const {
+    std::unique_lock lockGuard(cacheLock);
+    return usedBytes;
+}
@@ -0,0 +1,51 @@
+#ifndef UNTITLED7_CHUNKCACHE_H
+#define UNTITLED7_CHUNKCACHE_H
+
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+#include "Chunk.h"
+
+/*
+ * Holds the compressed terrain of recently unloaded chunks (see CompressedChunk), so that a chunk which is loaded again
+ * is restored rather than generated, keeping any changes made to it. Entries are kept in order of use, and the least
+ * recently used are dropped once the entries exceed maxBytes. A chunk's entry is removed when it is restored, as the
+ * loaded chunk is then the only up to date copy.
+ */
+
+class ChunkCache {
+    private:
+        struct CacheEntry {
+            ChunkPos chunkPos {};
+            std::unique_ptr<CompressedChunk> chunk {};
+            size_t bytes = 0;
+        };
+
+        // Most recently used first
+        std::list<CacheEntry> entries {};
+        std::unordered_map<ChunkPos, std::list<CacheEntry>::iterator> entryMap {};
+        mutable std::mutex cacheLock;
+
+        const size_t maxBytes;
+        size_t usedBytes = 0;
+
+        std::atomic<int> hits = 0;
+        std::atomic<int> misses = 0;
+
+    public:
+        explicit ChunkCache(size_t _maxBytes);
+
+        void Insert(const ChunkPos& _chunkPos, std::unique_ptr<CompressedChunk> _chunk);
+        [[nodiscard]] std::unique_ptr<CompressedChunk> Take(const ChunkPos& _chunkPos);
+        [[nodiscard]] bool Contains(const ChunkPos& _chunkPos) const;
+
+        // Debug
+        [[nodiscard]] int GetHits() const { return hits.load(std::memory_order_relaxed); }
+        [[nodiscard]] int GetMisses() const { return misses.load(std::memory_order_relaxed); }
+        [[nodiscard]] size_t GetUsedBytes() const;
+};
+
+#endif //UNTITLED7_CHUNKCACHE_H
@@ -0,0 +1,94 @@
+#include "ChunkEpochs.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Chunk.h"
+
+// Reader slot and pin nesting depth of the calling thread
+static thread_local int readerIndex = -1;
+static thread_local int pinDepth = 0;
+
+int ChunkEpochs::GetReaderIndex() {
+    if (readerIndex == -1) {
+        readerIndex = nReaders.fetch_add(1, std::memory_order_seq_cst);
+        if (readerIndex >= maxReaders) {
+            printf("TOO MANY CHUNK READER THREADS (MAX %d)\n", maxReaders);
+            std::abort();
+        }
+    }
+
+    return readerIndex;
+}
+
+
+
+/*
+ * Pinning publishes the epoch the reader started in. The fence orders the publish before any chunk pointer is loaded,
+ * so a writer which retires a chunk after the reader pinned will see the reader's epoch.
+ */
+
+void ChunkEpochs::Pin() {
+    if (pinDepth++ > 0) return;
+
+    std::atomic<uint64_t>& readerEpoch = readerEpochs[GetReaderIndex()];
+    readerEpoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void ChunkEpochs::Unpin() {
+    if (--pinDepth > 0) return;
+
+    readerEpochs[GetReaderIndex()].store(0, std::memory_order_release);
+}
+
+
+
+/*
+ * Retires a chunk which has been removed from the world. Readers which pinned before the epoch advanced may still hold
+ * it, so it is kept until they have unpinned.
+ */
+
+void ChunkEpochs::Retire(std::shared_ptr<Chunk> _chunk) {
+    if (_chunk == nullptr) return;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t retireEpoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+    {
+        std::unique_lock lockGuard(retiredLock);
+        retiredChunks.emplace_back(retireEpoch, std::move(_chunk));
+    }
+
+    Reclaim();
+}
+
+/*
+ * Drops the retired chunks which no pinned reader could have borrowed
+ */
+
+void ChunkEpochs::Reclaim() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Readers pinned at an epoch after a chunk was retired can not have borrowed it
+    uint64_t minPinned = UINT64_MAX;
+    int readers = std::min(nReaders.load(std::memory_order_seq_cst), maxReaders);
+    for (int r = 0; r < readers; r++) {
+        uint64_t readerEpoch = readerEpochs[r].load(std::memory_order_acquire);
+        if (readerEpoch != 0) minPinned = std::min(minPinned, readerEpoch);
+    }
+
+    // Chunks are dropped outside the lock, as releasing a chunk may reset or destroy it
+    std::vector<std::shared_ptr<Chunk>> reclaimed {};
+    {
+        std::unique_lock lockGuard(retiredLock);
+        for (auto& retired : retiredChunks) {
+            if (retired.first < minPinned) reclaimed.push_back(std::move(retired.second));
+        }
+
+        std::erase_if(retiredChunks, [](const std::pair<uint64_t, std::shared_ptr<Chunk>>& _retired) {
+            return _retired.second == nullptr;
+        });
+    }
+}
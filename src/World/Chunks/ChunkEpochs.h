@@ -0,0 +1,64 @@
+#ifndef UNTITLED7_CHUNKEPOCHS_H
+#define UNTITLED7_CHUNKEPOCHS_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "../WorldGenConsts.h"
+
+class Chunk;
+
+/*
+ * Epoch based reclamation of the chunks removed from the world, permitting chunks to be borrowed (as a plain Chunk*)
+ * without locking or reference counting. A thread borrowing chunks first pins the current epoch with a ChunkReadGuard.
+ * Removed chunks are retired with the epoch they were removed in, and their shared_ptr is only dropped once every
+ * thread which may have borrowed them has unpinned. Pins may be nested.
+ *
+ * Each thread which reads chunks is given one of maxReaders reader slots the first time it pins. The job pool's workers
+ * are limited to fewer than this (see maxChunkWorkers).
+ */
+
+class ChunkEpochs {
+    private:
+        static const int maxReaders = maxChunkReaders;
+
+        std::atomic<uint64_t> globalEpoch = 1;
+        std::array<std::atomic<uint64_t>, maxReaders> readerEpochs {}; // 0 whilst the reader is not pinned
+        std::atomic<int> nReaders = 0;
+
+        std::vector<std::pair<uint64_t, std::shared_ptr<Chunk>>> retiredChunks {};
+        std::mutex retiredLock;
+
+        [[nodiscard]] int GetReaderIndex();
+
+    public:
+        // Readers
+        void Pin();
+        void Unpin();
+
+        // Writers. Retire must only be called after the chunk has been removed from the world
+        void Retire(std::shared_ptr<Chunk> _chunk);
+        void Reclaim();
+};
+
+/*
+ * Pins the chunk epochs for its lifetime. Chunks borrowed whilst the guard exists must not be used after it is destroyed.
+ */
+
+class ChunkReadGuard {
+    private:
+        ChunkEpochs& epochs;
+
+    public:
+        explicit ChunkReadGuard(ChunkEpochs& _epochs) : epochs(_epochs) { epochs.Pin(); }
+        ~ChunkReadGuard() { epochs.Unpin(); }
+
+        ChunkReadGuard(const ChunkReadGuard&) = delete;
+        ChunkReadGuard& operator=(const ChunkReadGuard&) = delete;
+};
+
+#endif //UNTITLED7_CHUNKEPOCHS_H
@@ -0,0 +1,450 @@
+#include "ChunkJobPool.h"
+
+#include <algorithm>
+#include <utility>
+
+/*
+ * Creates the workers without starting them. By default there is one worker for every hardware thread except the one
+ * used by the main thread.
+ */
+
+ChunkJobPool::ChunkJobPool(int _nWorkers) {
+    int nWorkers = _nWorkers;
+    if (nWorkers <= 0) nWorkers = (int)std::thread::hardware_concurrency() - 1;
+    nWorkers = std::clamp(nWorkers, 1, maxChunkWorkers);
+
+    for (int w = 0; w < nWorkers; w++) workers.push_back(std::make_unique<Worker>());
+}
+
+/*
+ * Ensures the workers rejoin the main thread before program closure.
+ */
+
+ChunkJobPool::~ChunkJobPool() {
+    EndWorkers();
+}
+
+
+
+/*
+ * Assigns the function run by jobs of the given kind. Must be set for every kind of job queued before the workers are
+ * started.
+ */
+
+void ChunkJobPool::SetJobFunction(JOBKIND _kind, const std::function<THREAD_ACTION_RESULT(const glm::ivec2&)>& _jobFunction) {
+    jobFunctions[(int)_kind] = _jobFunction;
+}
+
+
+
+/*
+ * Starts the workers. The workers run until EndWorkers is called or the pool is destroyed.
+ */
+
+void ChunkJobPool::StartWorkers() {
+    if (enabled.exchange(true)) return;
+
+    for (int w = 0; w < (int)workers.size(); w++) {
+        workers[w]->thread = std::thread(&ChunkJobPool::WorkerLoop, this, w);
+    }
+}
+
+
+
+/*
+ * Stops the workers, discarding any jobs which have not been started, and waits for the running jobs to finish
+ */
+
+void ChunkJobPool::EndWorkers() {
+    {
+        std::unique_lock lock(workersMutex);
+        enabled = false;
+    }
+    workersCV.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+
+        std::unique_lock lock(worker->jobsLock);
+        for (const auto& job : worker->jobs) pendingJobs[(int)job.kind].fetch_sub(1, std::memory_order_release);
+        queuedJobs.fetch_sub((int)worker->jobs.size(), std::memory_order_relaxed);
+        worker->jobs.clear();
+        for (auto& queuedChunks : worker->queuedChunks) queuedChunks.clear();
+    }
+}
+
+
+
+/*
+ * Assigns function used to determine if a job of the given kind is still wanted, once the focus origin has moved since
+ * it was queued, or after it has returned "RETRY"
+ */
+
+void ChunkJobPool::SetWantedCheckFunction(JOBKIND _kind, const std::function<bool(const glm::ivec2&)>& _wantedCheckFunction) {
+    wantedChecks[(int)_kind] = _wantedCheckFunction;
+}
+
+
+
+/*
+ * Runs jobs until the pool is disabled, sleeping whilst no worker has queued jobs
+ */
+
+void ChunkJobPool::WorkerLoop(int _workerIndex) {
+    ThreadAction currentJob;
+
+    while (enabled) {
+        if (!TakeJob(_workerIndex, &currentJob)) {
+            std::unique_lock lock(workersMutex);
+            workersCV.wait(lock, [&]{ return !enabled || queuedJobs.load(std::memory_order_acquire) > 0; });
+            continue;
+        }
+
+        // The focus origin moved on since the job was queued, and it is no longer wanted
+        if (IsStale(currentJob)) {
+            staleJobs.fetch_add(1, std::memory_order_relaxed);
+            FinishJob(currentJob.kind);
+            continue;
+        }
+
+        auto st = std::chrono::high_resolution_clock::now();
+        THREAD_ACTION_RESULT res = jobFunctions[(int)currentJob.kind](currentJob.chunkPos);
+        auto et = std::chrono::high_resolution_clock::now();
+        RecordJobTime(std::chrono::duration_cast<std::chrono::nanoseconds>(et - st).count());
+
+        // Retried jobs are requeued whilst they are still wanted
+        bool requeue = false;
+        if (res == ThreadAction::RETRY) {
+            const auto& wantedCheck = wantedChecks[(int)currentJob.kind];
+            requeue = wantedCheck == nullptr || wantedCheck(currentJob.chunkPos);
+        }
+
+        // A requeued job stays pending, so the pool is never seen as idle between the job finishing and requeueing. It
+        // is queued behind the jobs of the same priority, and the worker yields first so that a job retrying on a busy
+        // chunk does not spin. If the same job was queued again whilst this one ran, the queued job replaces it
+        if (requeue) {
+            JobFocus jobFocus;
+            uint32_t jobFocusEpoch = GetFocus(&jobFocus);
+            JOBKIND kind = currentJob.kind;
+            currentJob.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+
+            if (PushJob(std::move(currentJob), jobFocus, jobFocusEpoch)) {
+                WakeWorkers(1);
+                continue;
+            }
+
+            duplicateJobs.fetch_add(1, std::memory_order_relaxed);
+            FinishJob(kind);
+        }
+        else FinishJob(currentJob.kind);
+    }
+}
+
+/*
+ * Only jobs queued before the focus origin last moved are checked
+ */
+
+bool ChunkJobPool::IsStale(const ThreadAction& _job) const {
+    if (_job.originEpoch == originEpoch.load(std::memory_order_relaxed)) return false;
+
+    const auto& wantedCheck = wantedChecks[(int)_job.kind];
+    return wantedCheck != nullptr && !wantedCheck(_job.chunkPos);
+}
+
+void ChunkJobPool::FinishJob(JOBKIND _kind) {
+    if (pendingJobs[(int)_kind].fetch_sub(1, std::memory_order_acq_rel) == 1 && !HasJobs()) {
+        PrintJobResults();
+    }
+}
+
+
+
+/*
+ * Takes the most pressing job of the worker's own heap, or otherwise steals the most pressing job of another worker's
+ * heap. Returns false if every heap is empty.
+ */
+
+bool ChunkJobPool::TakeJob(int _workerIndex, ThreadAction* _job) {
+    if (queuedJobs.load(std::memory_order_acquire) == 0) return false;
+
+    int nWorkers = (int)workers.size();
+    for (int i = 0; i < nWorkers; i++) {
+        Worker& worker = *workers[(_workerIndex + i) % nWorkers];
+
+        std::unique_lock lock(worker.jobsLock);
+        if (worker.jobs.empty()) continue;
+
+        PopJob(worker, _job);
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+
+
+/*
+ * Jobs without an affinity are spread across the workers by chunk position
+ */
+
+int ChunkJobPool::GetJobWorker(const ThreadAction& _job) const {
+    int nWorkers = (int)workers.size();
+    if (_job.affinity >= 0) return _job.affinity % nWorkers;
+
+    size_t hash = std::hash<int>()(_job.chunkPos.x * 73856093 ^ _job.chunkPos.y * 19349663);
+    return int(hash % nWorkers);
+}
+
+/*
+ * The job's priority is computed for the given focus. If the worker's heap was computed for a different focus, the heap
+ * is marked to be recomputed when next taken from. Returns false, without adding the job, if a job of the same kind is
+ * already queued for the chunk.
+ */
+
+bool ChunkJobPool::PushJob(ThreadAction _job, const JobFocus& _focus, uint32_t _focusEpoch) {
+    Worker& worker = *workers[GetJobWorker(_job)];
+    _job.priority = GetJobPriority(_job, _focus);
+
+    std::unique_lock lock(worker.jobsLock);
+    if (!worker.queuedChunks[(int)_job.kind].insert(GetChunkKey(_job.chunkPos)).second) {
+        if (!_job.urgent) return false;
+
+        // The queued job becomes a priority, so the new job is run no later than it would have been
+        auto queuedJob = std::find_if(worker.jobs.begin(), worker.jobs.end(), [&](const ThreadAction& _queued) {
+            return _queued.kind == _job.kind && _queued.chunkPos == _job.chunkPos;
+        });
+        if (queuedJob != worker.jobs.end() && !queuedJob->urgent) {
+            queuedJob->urgent = true;
+            std::make_heap(worker.jobs.begin(), worker.jobs.end(), RunsAfter);
+        }
+        return false;
+    }
+
+    if (worker.focusEpoch != _focusEpoch) worker.focusEpoch = 0;
+
+    worker.jobs.push_back(std::move(_job));
+    std::push_heap(worker.jobs.begin(), worker.jobs.end(), RunsAfter);
+
+    queuedJobs.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+/*
+ * Removes the most pressing job from the worker's heap, first recomputing the heap if the focus has changed since it was
+ * computed. The worker's jobs lock must be held.
+ */
+
+void ChunkJobPool::PopJob(Worker& _worker, ThreadAction* _job) {
+    if (_worker.focusEpoch != focusEpoch.load(std::memory_order_acquire)) {
+        JobFocus jobFocus;
+        _worker.focusEpoch = GetFocus(&jobFocus);
+
+        for (auto& job : _worker.jobs) job.priority = GetJobPriority(job, jobFocus);
+        std::make_heap(_worker.jobs.begin(), _worker.jobs.end(), RunsAfter);
+    }
+
+    std::pop_heap(_worker.jobs.begin(), _worker.jobs.end(), RunsAfter);
+    *_job = std::move(_worker.jobs.back());
+    _worker.jobs.pop_back();
+
+    // Once started, the chunk may be queued for the same kind of job again, as the job may not see later changes
+    _worker.queuedChunks[(int)_job->kind].erase(GetChunkKey(_job->chunkPos));
+}
+
+/*
+ * The workers mutex is taken before notifying, so a worker cannot miss the new jobs between checking for jobs and
+ * beginning to wait
+ */
+
+void ChunkJobPool::WakeWorkers(int _nJobs) {
+    { std::unique_lock lock(workersMutex); }
+
+    if (_nJobs == 1) workersCV.notify_one();
+    else workersCV.notify_all();
+}
+
+
+
+/*
+ * Jobs (which may be a list of 1 job) are added to their workers' heaps. Priority jobs are run before all other jobs.
+ * Jobs of equal priority run in the order they were added. Jobs for chunks which already have a job of the kind queued
+ * are skipped.
+ */
+
+void ChunkJobPool::AddJobs(JOBKIND _kind, std::vector<ThreadAction> _jobs, bool _priority) {
+    if (_jobs.empty()) return;
+    pendingJobs[(int)_kind].fetch_add((int)_jobs.size(), std::memory_order_release);
+
+    JobFocus jobFocus;
+    uint32_t jobFocusEpoch = GetFocus(&jobFocus);
+    uint32_t jobOriginEpoch = originEpoch.load(std::memory_order_relaxed);
+    uint64_t sequence = nextSequence.fetch_add(_jobs.size(), std::memory_order_relaxed);
+
+    int nAdded = 0;
+    for (auto& job : _jobs) {
+        job.kind = _kind;
+        job.urgent = _priority;
+        job.sequence = sequence++;
+        job.originEpoch = jobOriginEpoch;
+        if (PushJob(std::move(job), jobFocus, jobFocusEpoch)) nAdded++;
+    }
+
+    int nDuplicates = (int)_jobs.size() - nAdded;
+    if (nDuplicates > 0) {
+        duplicateJobs.fetch_add(nDuplicates, std::memory_order_relaxed);
+        pendingJobs[(int)_kind].fetch_sub(nDuplicates, std::memory_order_acq_rel);
+    }
+
+    if (nAdded > 0) WakeWorkers(nAdded);
+}
+
+
+
+/*
+ * Job is applied to the job's chunk position, and a radius of chunks around it (a diamond, or a square if
+ * _squareRegion)
+ */
+
+void ChunkJobPool::AddJobRegion(JOBKIND _kind, const ThreadAction& _originJob, int _radius, bool _squareRegion,
+                                bool _priority) {
+    std::vector<ThreadAction> jobs;
+    jobs.reserve((2*_radius + 1) * (2*_radius + 1));
+    for (int x = -_radius; x < _radius + 1; x++) {
+        for (int z = -_radius; z < _radius + 1; z++) {
+            if (!_squareRegion && std::abs(x) + std::abs(z) > _radius) continue;
+            jobs.push_back(_originJob);
+            jobs.back().chunkPos += glm::ivec2{x,z};
+        }
+    }
+
+    AddJobs(_kind, std::move(jobs), _priority);
+}
+
+
+
+/*
+ * Moves the focus that the queued jobs are ordered around. Small turns of the facing direction are ignored, so that the
+ * heaps are not recomputed every frame whilst the player looks around.
+ */
+
+void ChunkJobPool::SetFocus(const glm::ivec2& _origin, const glm::vec3& _facingDirection) {
+    glm::vec2 facing = {_facingDirection.x, _facingDirection.z};
+    if (glm::length(facing) > 0) facing = glm::normalize(facing);
+
+    std::unique_lock lock(focusLock);
+    if (_origin == focus.origin && (facing == focus.facing || glm::dot(facing, focus.facing) >= jobFocusTurnCos)) return;
+
+    // Jobs queued around the previous origin are checked for staleness when taken
+    if (_origin != focus.origin) originEpoch.fetch_add(1, std::memory_order_relaxed);
+
+    focus = {_origin, facing};
+    focusEpoch.fetch_add(1, std::memory_order_release);
+}
+
+/*
+ * Jobs queued before this are checked for staleness when taken, as when the focus origin moves. Called when the regions
+ * jobs are wanted within change without the origin moving.
+ */
+
+void ChunkJobPool::ExpireQueuedJobs() {
+    originEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t ChunkJobPool::GetFocus(JobFocus* _focus) {
+    std::unique_lock lock(focusLock);
+    *_focus = focus;
+    return focusEpoch.load(std::memory_order_relaxed);
+}
+
+/*
+ * Lower priorities run first. Each chunk of distance from the focus origin adds 4.
+ * The chunks surrounding the origin are always treated as in view, as the player is stood amongst them.
+ */
+
+int ChunkJobPool::GetJobPriority(const ThreadAction& _job, const JobFocus& _focus) {
+    glm::vec2 offset = glm::vec2(_job.chunkPos - _focus.origin);
+    float distance = glm::length(offset);
+
+    float priority = distance;
+    if (distance > 1.5f && _focus.facing != glm::vec2{0, 0} && glm::dot(offset / distance, _focus.facing) < jobViewConeCos) {
+        priority += jobOffViewPenalty;
+    }
+
+    return int(priority * 4.0f);
+}
+
+/*
+ * Heap ordering, true if _a runs after _b
+ */
+
+bool ChunkJobPool::RunsAfter(const ThreadAction& _a, const ThreadAction& _b) {
+    if (_a.urgent != _b.urgent) return _b.urgent;
+    if (_a.kind != _b.kind) return _a.kind > _b.kind;
+    if (_a.priority != _b.priority) return _a.priority > _b.priority;
+    return _a.sequence > _b.sequence;
+}
+
+
+
+bool ChunkJobPool::HasJobs() const {
+    for (const auto& pending : pendingJobs) {
+        if (pending.load(std::memory_order_acquire) > 0) return true;
+    }
+
+    return false;
+}
+
+
+
+/*
+ * Output to console the time results for jobs undertaken.
+ * Occurs only when no more jobs are pending
+ */
+
+void ChunkJobPool::RecordJobTime(Uint64 _nsTaken) {
+    std::unique_lock lock(timerLock);
+
+    allActions++;
+    if (_nsTaken > 500000) {
+        heavyActions.actionsCompleted++;
+        heavyActions.sumNStaken += _nsTaken;
+    } else {
+        lightActions.actionsCompleted++;
+        lightActions.sumNStaken += _nsTaken;
+    }
+}
+
+void ChunkJobPool::PrintJobResults() {
+    std::unique_lock lock(timerLock);
+
+    if (allActions == 0) return;
+    if (lightActions.actionsCompleted == 0 && heavyActions.actionsCompleted == 0) return;
+
+    printf("<JOB_POOL %d WORKERS> SINCE LAST ACTIONS . . .\n", (int)workers.size());
+    printf("\t%d DUPLICATE JOBS SKIPPED | %d STALE JOBS DROPPED IN TOTAL\n", GetDuplicateJobs(), GetStaleJobs());
+
+    // Heavy actions
+    if (heavyActions.actionsCompleted > 0) {
+        heavyActions.avgNStaken = heavyActions.sumNStaken / heavyActions.actionsCompleted;
+        printf("\t%d HEAVY ACTIONS COMPLETED IN %llu MS | AVG MS PER ACTION %llu\n",
+               heavyActions.actionsCompleted, heavyActions.sumNStaken / 1000000, heavyActions.avgNStaken / 1000000);
+
+        heavyActions.actionsCompleted = 0;
+        heavyActions.sumNStaken = 0;
+    }
+
+    // Light actions
+    if (lightActions.actionsCompleted > 0) {
+        lightActions.avgNStaken = lightActions.sumNStaken / lightActions.actionsCompleted;
+
+        printf("\t%d LIGHT ACTIONS COMPLETED IN %llu MU | AVG MU PER ACTION %llu\n",
+               lightActions.actionsCompleted, lightActions.sumNStaken / 1000, lightActions.avgNStaken / 1000);
+
+        lightActions.actionsCompleted = 0;
+        lightActions.sumNStaken = 0;
+    }
+
+    allActions = 0;
+}
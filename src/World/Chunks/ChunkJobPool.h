@@ -0,0 +1,188 @@
+#ifndef UNTITLED7_CHUNKJOBPOOL_H
+#define UNTITLED7_CHUNKJOBPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include <vector>
+#include <array>
+#include <unordered_set>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+#include <SDL.h>
+
+#include "../WorldGenConsts.h"
+
+typedef int THREAD_ACTION_RESULT;
+
+/*
+ * The kinds of work done on chunks by the job pool, in the order that queued jobs run (see ChunkJobPool::RunsAfter)
+ */
+
+enum class JOBKIND : int {
+    CREATE, GENERATE, MESH, UNLOAD, nJobKinds
+};
+
+/*
+ * Simple struct to house a position of the chunk that the job function of the job's kind will be applied to (see
+ * ChunkJobPool::SetJobFunction). Holds no callable of its own, so queueing, moving and retrying jobs never allocates.
+ * affinity is the worker the job should be queued on, or -1 to choose a worker from the chunk position. kind, priority,
+ * sequence and originEpoch are set by the job pool when the job is queued (see ChunkJobPool::GetJobPriority).
+ */
+
+struct ThreadAction {
+    glm::ivec2 chunkPos {0, 0};
+    int affinity = -1;
+    JOBKIND kind = JOBKIND::GENERATE;
+
+    // Ordering within the job pool, lowest first
+    bool urgent = false;
+    int priority = 0;
+    uint64_t sequence = 0;
+    uint32_t originEpoch = 0;
+
+    enum {
+        OK, FAIL, RETRY, // ...
+    };
+};
+
+static_assert(std::is_trivially_copyable_v<ThreadAction>, "chunk jobs are copied and moved by the job pool's heaps");
+
+
+/*
+ * Where the player is and which way they face, used to order the queued jobs
+ */
+
+struct JobFocus {
+    glm::ivec2 origin {0, 0};
+    glm::vec2 facing {0, 0};
+};
+
+/*
+ *
+ */
+
+struct ActionTimer {
+    int actionsCompleted = 0;
+    Uint64 avgNStaken = 0;
+    Uint64 sumNStaken = 0;
+};
+
+
+
+/*
+ * Runs chunk jobs on a pool of worker threads, one per hardware thread not used by the main thread. Each worker owns a
+ * heap of jobs, taking the most pressing job from its own heap, and when it is empty, stealing the most pressing job of
+ * another worker. Priority jobs are run before all others. Otherwise, jobs run in order of their kind (see JOBKIND), so
+ * chunks are created before any are generated and generated before any are meshed. Within a kind, jobs nearer the
+ * focus origin run first, and jobs outside of the focus' view run after visible jobs a few chunks further away.
+ *
+ * Moving or turning the focus (see SetFocus) only increments the focus epoch. Each heap recomputes its jobs' priorities
+ * the next time a job is taken from it, so re-prioritising costs nothing whilst the jobs wait.
+ *
+ * At most one job of each kind is queued for a chunk. Adding a job for a chunk which already has one of the same kind
+ * queued only raises the queued job to a priority if the new job is one. As the duplicate is found through the worker
+ * chosen for the job, jobs given different affinities are not deduplicated against each other.
+ *
+ * The wanted check of a job's kind (if set) decides whether the job is still wanted. Jobs queued before the focus origin
+ * last moved are checked when taken, and dropped as stale if no longer wanted. Jobs returning RETRY are checked, and
+ * queued again behind the jobs of the same priority if still wanted.
+ */
+
+class ChunkJobPool {
+    private:
+        struct Worker {
+            std::vector<ThreadAction> jobs {}; // heap, most pressing job at the front
+            uint32_t focusEpoch = 0; // focus epoch the priorities in the heap were computed for
+            std::array<std::unordered_set<uint64_t>, (int)JOBKIND::nJobKinds> queuedChunks {}; // see GetChunkKey
+            std::mutex jobsLock;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers {};
+        std::array<std::function<THREAD_ACTION_RESULT(const glm::ivec2&)>, (int)JOBKIND::nJobKinds> jobFunctions {};
+        std::array<std::function<bool(const glm::ivec2&)>, (int)JOBKIND::nJobKinds> wantedChecks {};
+
+        // Jobs in the heaps, and jobs queued or running of each kind
+        std::atomic<int> queuedJobs = 0;
+        std::array<std::atomic<int>, (int)JOBKIND::nJobKinds> pendingJobs {};
+
+        // Job ordering. Epochs start at 1, so a heap with epoch 0 is always recomputed
+        JobFocus focus {};
+        std::atomic<uint32_t> focusEpoch = 1;
+        std::atomic<uint32_t> originEpoch = 1;
+        std::mutex focusLock;
+        std::atomic<uint64_t> nextSequence = 0;
+
+        // Jobs not run as a job of the same kind was already queued for the chunk, or as they were no longer wanted
+        std::atomic<int> duplicateJobs = 0;
+        std::atomic<int> staleJobs = 0;
+
+        // Sleeping workers
+        std::condition_variable workersCV;
+        std::mutex workersMutex;
+        std::atomic<bool> enabled = false;
+
+        // action time measurements
+        std::mutex timerLock;
+        ActionTimer lightActions;
+        ActionTimer heavyActions;
+        unsigned int allActions = 0;
+
+        // Worker functionality
+        void WorkerLoop(int _workerIndex);
+        [[nodiscard]] bool TakeJob(int _workerIndex, ThreadAction* _job);
+        [[nodiscard]] int GetJobWorker(const ThreadAction& _job) const;
+        [[nodiscard]] bool PushJob(ThreadAction _job, const JobFocus& _focus, uint32_t _focusEpoch);
+        void PopJob(Worker& _worker, ThreadAction* _job);
+        [[nodiscard]] bool IsStale(const ThreadAction& _job) const;
+        void FinishJob(JOBKIND _kind);
+        void WakeWorkers(int _nJobs);
+        void RecordJobTime(Uint64 _nsTaken);
+
+        // Job ordering
+        [[nodiscard]] uint32_t GetFocus(JobFocus* _focus);
+        [[nodiscard]] static int GetJobPriority(const ThreadAction& _job, const JobFocus& _focus);
+        [[nodiscard]] static bool RunsAfter(const ThreadAction& _a, const ThreadAction& _b);
+        [[nodiscard]] static uint64_t GetChunkKey(const glm::ivec2& _chunkPos) {
+            return (uint64_t)(uint32_t)_chunkPos.x << 32 | (uint32_t)_chunkPos.y;
+        }
+
+    public:
+        explicit ChunkJobPool(int _nWorkers = 0);
+        ~ChunkJobPool();
+
+        // Pool Management
+        void SetJobFunction(JOBKIND _kind, const std::function<THREAD_ACTION_RESULT(const glm::ivec2&)>& _jobFunction);
+        void StartWorkers();
+        void EndWorkers();
+        void SetWantedCheckFunction(JOBKIND _kind, const std::function<bool(const glm::ivec2&)>& _wantedCheckFunction);
+        void SetFocus(const glm::ivec2& _origin, const glm::vec3& _facingDirection);
+        void ExpireQueuedJobs();
+
+        // Adding new jobs to be completed by the workers
+        void AddJobs(JOBKIND _kind, std::vector<ThreadAction> _jobs, bool _priority = false);
+        void AddJobRegion(JOBKIND _kind, const ThreadAction& _originJob, int _radius, bool _squareRegion = false,
+                          bool _priority = false);
+
+        // Debug Output
+        void PrintJobResults();
+
+        //
+        [[nodiscard]] int GetWorkerCount() const { return (int)workers.size(); }
+        [[nodiscard]] bool HasJobs(JOBKIND _kind) const {
+            return pendingJobs[(int)_kind].load(std::memory_order_acquire) > 0;
+        }
+        [[nodiscard]] bool HasJobs() const;
+        [[nodiscard]] int GetDuplicateJobs() const { return duplicateJobs.load(std::memory_order_relaxed); }
+        [[nodiscard]] int GetStaleJobs() const { return staleJobs.load(std::memory_order_relaxed); }
+};
+
+#endif //UNTITLED7_CHUNKJOBPOOL_H
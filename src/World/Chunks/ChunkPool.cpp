@@ -0,0 +1,49 @@
+#include "ChunkPool.h"
+
+ChunkPool::ChunkPool(int _maxFreeChunks) : maxFreeChunks(_maxFreeChunks) {
+    freeChunks.reserve(maxFreeChunks);
+}
+
+
+
+/*
+ * Returns a chunk at the given position, recycling a previously released chunk if one is available
+ */
+
+std::shared_ptr<Chunk> ChunkPool::Acquire(const glm::vec3& _chunkPosition, const ChunkData& _chunkData) {
+    std::unique_ptr<Chunk> chunk {};
+
+    {
+        std::unique_lock lockGuard(poolLock);
+        if (!freeChunks.empty()) {
+            chunk = std::move(freeChunks.back());
+            freeChunks.pop_back();
+        }
+    }
+
+    // Reset outside the pool lock, as clearing the chunk's terrain and meshes is not free
+    if (chunk != nullptr) chunk->Reset(_chunkPosition, _chunkData);
+    else chunk = std::make_unique<Chunk>(_chunkPosition, _chunkData);
+
+    return {chunk.release(), [this](Chunk* _chunk) { Release(_chunk); }};
+}
+
+
+
+/*
+ * Called once the last reference to a chunk is dropped. The chunk is kept for reuse, or destroyed if the pool is full.
+ */
+
+void ChunkPool::Release(Chunk* _chunk) {
+    std::unique_ptr<Chunk> chunk(_chunk);
+
+    std::unique_lock lockGuard(poolLock);
+    if ((int)freeChunks.size() < maxFreeChunks) freeChunks.push_back(std::move(chunk));
+}
+
+
+
+int ChunkPool::GetFreeChunks() {
+    std::unique_lock lockGuard(poolLock);
+    return (int)freeChunks.size();
+}
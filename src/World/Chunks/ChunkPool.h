@@ -0,0 +1,36 @@
+#ifndef UNTITLED7_CHUNKPOOL_H
+#define UNTITLED7_CHUNKPOOL_H
+
+#include <memory>
+#include <vector>
+#include <mutex>
+
+#include "Chunk.h"
+
+/*
+ * Recycles unloaded chunks. Chunks are handed out as shared_ptrs which return the chunk to the pool, rather than
+ * destroying it, once the last reference is dropped. Acquiring a chunk resets a pooled chunk in place (see
+ * Chunk::Reset), so crossing chunk borders reuses the terrain storages and block meshes of the chunks that were
+ * unloaded instead of reallocating them. At most maxFreeChunks are held, past which released chunks are destroyed.
+ *
+ * The pool must outlive every chunk it has handed out.
+ */
+
+class ChunkPool {
+    private:
+        std::vector<std::unique_ptr<Chunk>> freeChunks {};
+        std::mutex poolLock;
+        const int maxFreeChunks;
+
+        void Release(Chunk* _chunk);
+
+    public:
+        explicit ChunkPool(int _maxFreeChunks);
+
+        [[nodiscard]] std::shared_ptr<Chunk> Acquire(const glm::vec3& _chunkPosition, const ChunkData& _chunkData);
+
+        // Debug
+        [[nodiscard]] int GetFreeChunks();
+};
+
+#endif //UNTITLED7_CHUNKPOOL_H
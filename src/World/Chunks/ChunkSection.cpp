@@ -0,0 +1,504 @@
+#include "ChunkSection.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/*
+ * Waits before a seqlock read is retried. Writes are short, so the reader spins briefly before yielding its thread.
+ */
+
+static void ReadBackoff(int _attempt) {
+    if (_attempt < 16) {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#endif
+        return;
+    }
+
+    std::this_thread::yield();
+}
+
+/*
+ * SECTION STORAGE
+ */
+
+SectionStorage::SectionStorage(int _bitsPerIndex) : bitsPerIndex(_bitsPerIndex) {
+    int maxPaletteSize = std::min(1 << bitsPerIndex, sectionVolume);
+
+    palette.assign(maxPaletteSize, airState);
+    paletteCounts.assign(maxPaletteSize, 0);
+    packedIndexes.assign((sectionVolume * bitsPerIndex) / 64, 0);
+}
+
+
+
+/*
+ * Returns the palette index stored for the block. A storage with 0 bits per index only holds a single block state.
+ * Packed indexes and palette entries are accessed atomically as readers do not hold the section lock.
+ */
+
+int SectionStorage::GetPaletteIndex(int _blockIndex) const {
+    if (bitsPerIndex == 0) return 0;
+
+    // Indexes never straddle two words as bitsPerIndex is always a power of 2
+    int indexesPerWord = 64 / bitsPerIndex;
+    auto& word = const_cast<uint64_t&>(packedIndexes[_blockIndex / indexesPerWord]);
+    int shift = (_blockIndex % indexesPerWord) * bitsPerIndex;
+
+    uint64_t wordValue = std::atomic_ref<uint64_t>(word).load(std::memory_order_relaxed);
+    return int((wordValue >> shift) & ((uint64_t(1) << bitsPerIndex) - 1));
+}
+
+void SectionStorage::SetPaletteIndex(int _blockIndex, int _paletteIndex) {
+    if (bitsPerIndex == 0) return;
+
+    int indexesPerWord = 64 / bitsPerIndex;
+    std::atomic_ref<uint64_t> word(packedIndexes[_blockIndex / indexesPerWord]);
+    int shift = (_blockIndex % indexesPerWord) * bitsPerIndex;
+    uint64_t mask = ((uint64_t(1) << bitsPerIndex) - 1) << shift;
+
+    uint64_t wordValue = word.load(std::memory_order_relaxed);
+    word.store((wordValue & ~mask) | ((uint64_t(_paletteIndex) << shift) & mask), std::memory_order_relaxed);
+}
+
+void SectionStorage::SetPaletteEntry(int _paletteIndex, BlockStateID _blockState) {
+    std::atomic_ref<BlockStateID>(palette[_paletteIndex]).store(_blockState, std::memory_order_relaxed);
+}
+
+void SectionStorage::Clear() {
+    for (auto& word : packedIndexes) std::atomic_ref<uint64_t>(word).store(0, std::memory_order_relaxed);
+    for (int p = 0; p < paletteSize; p++) SetPaletteEntry(p, airState);
+
+    std::fill(paletteCounts.begin(), paletteCounts.end(), 0);
+    paletteSize = 0;
+}
+
+
+
+/*
+ * CHUNK SECTION
+ */
+
+ChunkSection::ChunkSection() {
+    SectionStorage* airStorage = GetUnusedStorage(0);
+    airStorage->SetPaletteEntry(0, airState);
+    airStorage->paletteCounts[0] = sectionVolume;
+    airStorage->paletteSize = 1;
+
+    storage.store(airStorage, std::memory_order_release);
+}
+
+
+
+/*
+ * Returns a storage for the given bitsPerIndex which is not the current storage, reusing a previous storage if the
+ * section has one. Must only be called whilst writing.
+ */
+
+SectionStorage* ChunkSection::GetUnusedStorage(int _bitsPerIndex) {
+    SectionStorage* currentStorage = storage.load(std::memory_order_relaxed);
+
+    for (auto& sectionStorage : storages) {
+        if (sectionStorage->bitsPerIndex != _bitsPerIndex || sectionStorage.get() == currentStorage) continue;
+
+        sectionStorage->Clear();
+        return sectionStorage.get();
+    }
+
+    storages.push_back(std::make_unique<SectionStorage>(_bitsPerIndex));
+    return storages.back().get();
+}
+
+
+
+/*
+ * Finds the palette entry of the given block state. If the state is not yet in the palette, it replaces an unused
+ * entry, or is added and the packed indexes are widened if the palette no longer fits in the current bitsPerIndex.
+ * Must only be called whilst writing.
+ */
+
+int ChunkSection::GetOrAddPaletteEntry(BlockStateID _blockState) {
+    SectionStorage* currentStorage = storage.load(std::memory_order_relaxed);
+
+    int unusedEntry = -1;
+    for (int p = 0; p < currentStorage->paletteSize; p++) {
+        if (currentStorage->palette[p] == _blockState) return p;
+        if (unusedEntry == -1 && currentStorage->paletteCounts[p] == 0) unusedEntry = p;
+    }
+
+    if (unusedEntry != -1) {
+        currentStorage->SetPaletteEntry(unusedEntry, _blockState);
+        return unusedEntry;
+    }
+
+    if (currentStorage->paletteSize == (int)currentStorage->palette.size()) {
+        int bitsPerIndex = currentStorage->bitsPerIndex;
+        WidenIndexes(bitsPerIndex == 0 ? 1 : bitsPerIndex * 2);
+        currentStorage = storage.load(std::memory_order_relaxed);
+    }
+
+    currentStorage->SetPaletteEntry(currentStorage->paletteSize, _blockState);
+    return currentStorage->paletteSize++;
+}
+
+
+
+/*
+ * Repacks the palette and palette indexes of every block in the section into a storage using the new number of bits
+ * per index. Must only be called whilst writing.
+ */
+
+void ChunkSection::WidenIndexes(int _bitsPerIndex) {
+    SectionStorage* oldStorage = storage.load(std::memory_order_relaxed);
+    SectionStorage* newStorage = GetUnusedStorage(_bitsPerIndex);
+
+    for (int p = 0; p < oldStorage->paletteSize; p++) {
+        newStorage->SetPaletteEntry(p, oldStorage->palette[p]);
+        newStorage->paletteCounts[p] = oldStorage->paletteCounts[p];
+    }
+    newStorage->paletteSize = oldStorage->paletteSize;
+
+    // Cleared storages already index palette entry 0 for every block
+    if (oldStorage->bitsPerIndex != 0) {
+        for (int i = 0; i < sectionVolume; i++) newStorage->SetPaletteIndex(i, oldStorage->GetPaletteIndex(i));
+    }
+
+    storage.store(newStorage, std::memory_order_release);
+}
+
+/*
+ * Once every block in the section uses the same palette entry, the packed indexes are no longer required. Must only be
+ * called whilst writing.
+ */
+
+void ChunkSection::CollapseToUniform(int _paletteIndex) {
+    SectionStorage* oldStorage = storage.load(std::memory_order_relaxed);
+    SectionStorage* newStorage = GetUnusedStorage(0);
+
+    newStorage->SetPaletteEntry(0, oldStorage->palette[_paletteIndex]);
+    newStorage->paletteCounts[0] = sectionVolume;
+    newStorage->paletteSize = 1;
+
+    storage.store(newStorage, std::memory_order_release);
+}
+
+
+
+/*
+ * Block getting / setting. Setting a block clears any unique attributes it had.
+ *
+ * Reads do not lock the section. If the version is odd, or changes during the read, a write was in progress and the
+ * read is retried.
+ */
+
+BlockStateID ChunkSection::GetBlockState(int _blockIndex) const {
+    for (int attempt = 0;; attempt++) {
+        uint32_t startVersion = version.load(std::memory_order_acquire);
+
+        if ((startVersion & 1) == 0) {
+            const SectionStorage* readStorage = storage.load(std::memory_order_acquire);
+            auto& entry = const_cast<BlockStateID&>(readStorage->palette[readStorage->GetPaletteIndex(_blockIndex)]);
+            BlockStateID blockState = std::atomic_ref<BlockStateID>(entry).load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == startVersion) return blockState;
+        }
+
+        ReadBackoff(attempt);
+    }
+}
+
+void ChunkSection::SetBlockState(int _blockIndex, BlockStateID _blockState) {
+    std::unique_lock lockGuard(sectionLock);
+
+    auto attributesIter = FindUniqueAttributes(_blockIndex);
+    if (attributesIter != uniqueAttributes.end()) {
+        uniqueAttributes.erase(attributesIter);
+        nUniqueAttributes.store((int)uniqueAttributes.size(), std::memory_order_relaxed);
+    }
+
+    SectionStorage* currentStorage = storage.load(std::memory_order_relaxed);
+    int oldPaletteIndex = currentStorage->GetPaletteIndex(_blockIndex);
+    BlockStateID oldBlockState = currentStorage->palette[oldPaletteIndex];
+    if (oldBlockState == _blockState) return;
+
+    // Begin write
+    uint32_t startVersion = version.load(std::memory_order_relaxed);
+    version.store(startVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    int newPaletteIndex = GetOrAddPaletteEntry(_blockState);
+    currentStorage = storage.load(std::memory_order_relaxed);
+
+    currentStorage->paletteCounts[oldPaletteIndex]--;
+    currentStorage->paletteCounts[newPaletteIndex]++;
+    currentStorage->SetPaletteIndex(_blockIndex, newPaletteIndex);
+
+    if (currentStorage->paletteCounts[newPaletteIndex] == sectionVolume) CollapseToUniform(newPaletteIndex);
+
+    // End write
+    version.store(startVersion + 2, std::memory_order_release);
+
+    int airChange = (oldBlockState == airState ? 1 : 0) - (_blockState == airState ? 1 : 0);
+    nonAirBlocks.fetch_add(airChange, std::memory_order_relaxed);
+}
+
+
+
+/*
+ * Returns the position in the unique attributes of the given block index, or end() if it has none
+ */
+
+std::vector<std::pair<uint16_t, BlockAttributes>>::iterator ChunkSection::FindUniqueAttributes(int _blockIndex) {
+    auto iter = std::lower_bound(uniqueAttributes.begin(), uniqueAttributes.end(), _blockIndex,
+                                 [](const std::pair<uint16_t, BlockAttributes>& _entry, int _index) {
+                                     return _entry.first < _index;
+                                 });
+
+    if (iter == uniqueAttributes.end() || iter->first != _blockIndex) return uniqueAttributes.end();
+    return iter;
+}
+
+
+
+/*
+ * Fetches the unique attributes of the block into _attributes. Returns false if the block has no unique attributes,
+ * in which case the block uses its default attributes.
+ */
+
+bool ChunkSection::GetUniqueAttributes(int _blockIndex, BlockAttributes* _attributes) {
+    // Most sections have no unique attributes, so avoid locking the section
+    if (nUniqueAttributes.load(std::memory_order_relaxed) == 0) return false;
+
+    std::unique_lock lockGuard(sectionLock);
+
+    auto attributesIter = FindUniqueAttributes(_blockIndex);
+    if (attributesIter == uniqueAttributes.end()) return false;
+
+    *_attributes = attributesIter->second;
+    return true;
+}
+
+void ChunkSection::SetUniqueAttributes(int _blockIndex, const BlockAttributes &_attributes) {
+    std::unique_lock lockGuard(sectionLock);
+
+    // Insert whilst keeping the side table sorted by block index
+    auto iter = std::lower_bound(uniqueAttributes.begin(), uniqueAttributes.end(), _blockIndex,
+                                 [](const std::pair<uint16_t, BlockAttributes>& _entry, int _index) {
+                                     return _entry.first < _index;
+                                 });
+
+    if (iter != uniqueAttributes.end() && iter->first == _blockIndex) iter->second = _attributes;
+    else uniqueAttributes.insert(iter, {uint16_t(_blockIndex), _attributes});
+
+    nUniqueAttributes.store((int)uniqueAttributes.size(), std::memory_order_relaxed);
+}
+
+void ChunkSection::ClearUniqueAttributes(int _blockIndex) {
+    std::unique_lock lockGuard(sectionLock);
+
+    auto attributesIter = FindUniqueAttributes(_blockIndex);
+    if (attributesIter != uniqueAttributes.end()) uniqueAttributes.erase(attributesIter);
+
+    nUniqueAttributes.store((int)uniqueAttributes.size(), std::memory_order_relaxed);
+}
+
+
+
+void ChunkSection::CopyUniqueAttributes(std::vector<std::pair<uint16_t, BlockAttributes>>* _attributes) {
+    _attributes->clear();
+    if (nUniqueAttributes.load(std::memory_order_relaxed) == 0) return;
+
+    std::unique_lock lockGuard(sectionLock);
+    _attributes->assign(uniqueAttributes.begin(), uniqueAttributes.end());
+}
+
+
+
+/*
+ * Returns the section to entirely air. Only called for a recycled chunk (see ChunkPool), which no reader can still see,
+ * so the storages other than the air storage are released, keeping the storage last in use as a spare for the new
+ * chunk's terrain.
+ */
+
+void ChunkSection::Reset() {
+    std::unique_lock lockGuard(sectionLock);
+
+    uniqueAttributes.clear();
+    nUniqueAttributes.store(0, std::memory_order_relaxed);
+
+    // Begin write
+    uint32_t startVersion = version.load(std::memory_order_relaxed);
+    version.store(startVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // A uniform section already uses the only 0 bits per index storage, so clear it rather than fetching another
+    SectionStorage* spareStorage = storage.load(std::memory_order_relaxed);
+    SectionStorage* airStorage = spareStorage;
+    if (airStorage->bitsPerIndex == 0) airStorage->Clear();
+    else airStorage = GetUnusedStorage(0);
+
+    airStorage->SetPaletteEntry(0, airState);
+    airStorage->paletteCounts[0] = sectionVolume;
+    airStorage->paletteSize = 1;
+    storage.store(airStorage, std::memory_order_release);
+
+    // End write
+    version.store(startVersion + 2, std::memory_order_release);
+
+    nonAirBlocks.store(0, std::memory_order_relaxed);
+
+    std::erase_if(storages, [&](const std::unique_ptr<SectionStorage>& _storage) {
+        return _storage.get() != airStorage && _storage.get() != spareStorage;
+    });
+}
+
+
+
+/*
+ * Writes the section's blocks as runs of palette entries, leaving out palette entries no longer used by any block
+ */
+
+void ChunkSection::Compress(CompressedSection* _compressed) {
+    std::unique_lock lockGuard(sectionLock);
+
+    SectionStorage* currentStorage = storage.load(std::memory_order_relaxed);
+
+    // Map the storage's palette indexes onto the used entries only
+    std::vector<int> compressedIndexes(currentStorage->paletteSize, -1);
+    _compressed->palette.clear();
+    for (int p = 0; p < currentStorage->paletteSize; p++) {
+        if (currentStorage->paletteCounts[p] == 0) continue;
+
+        compressedIndexes[p] = (int)_compressed->palette.size();
+        _compressed->palette.push_back(currentStorage->palette[p]);
+    }
+
+    _compressed->runs.clear();
+    int runIndex = compressedIndexes[currentStorage->GetPaletteIndex(0)];
+    int runLength = 0;
+    for (int i = 0; i < sectionVolume; i++) {
+        int paletteIndex = compressedIndexes[currentStorage->GetPaletteIndex(i)];
+        if (paletteIndex != runIndex) {
+            _compressed->runs.push_back(uint32_t(runIndex) << 16 | uint32_t(runLength - 1));
+            runIndex = paletteIndex;
+            runLength = 0;
+        }
+        runLength++;
+    }
+    _compressed->runs.push_back(uint32_t(runIndex) << 16 | uint32_t(runLength - 1));
+    _compressed->runs.shrink_to_fit();
+
+    _compressed->uniqueAttributes = uniqueAttributes;
+}
+
+/*
+ * Replaces the section's blocks with those of a compressed section, packing them directly into a storage of the
+ * narrowest bitsPerIndex which fits the compressed palette
+ */
+
+void ChunkSection::Decompress(const CompressedSection& _compressed) {
+    std::unique_lock lockGuard(sectionLock);
+
+    int bitsPerIndex = 0;
+    while ((1 << bitsPerIndex) < (int)_compressed.palette.size()) bitsPerIndex = (bitsPerIndex == 0 ? 1 : bitsPerIndex * 2);
+
+    // Begin write
+    uint32_t startVersion = version.load(std::memory_order_relaxed);
+    version.store(startVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Readers retry whilst writing, so the current storage may be cleared if it is already the right width
+    SectionStorage* newStorage = storage.load(std::memory_order_relaxed);
+    if (newStorage->bitsPerIndex == bitsPerIndex) newStorage->Clear();
+    else newStorage = GetUnusedStorage(bitsPerIndex);
+
+    for (int p = 0; p < (int)_compressed.palette.size(); p++) newStorage->SetPaletteEntry(p, _compressed.palette[p]);
+    newStorage->paletteSize = (int)_compressed.palette.size();
+
+    int blockIndex = 0;
+    int airBlocks = 0;
+    for (uint32_t run : _compressed.runs) {
+        int paletteIndex = int(run >> 16);
+        int runLength = int(run & 0xFFFF) + 1;
+
+        newStorage->paletteCounts[paletteIndex] += runLength;
+        if (_compressed.palette[paletteIndex] == airState) airBlocks += runLength;
+
+        for (int i = 0; i < runLength; i++) newStorage->SetPaletteIndex(blockIndex++, paletteIndex);
+    }
+
+    storage.store(newStorage, std::memory_order_release);
+
+    // End write
+    version.store(startVersion + 2, std::memory_order_release);
+
+    nonAirBlocks.store(sectionVolume - airBlocks, std::memory_order_relaxed);
+
+    uniqueAttributes = _compressed.uniqueAttributes;
+    nUniqueAttributes.store((int)uniqueAttributes.size(), std::memory_order_relaxed);
+}
+
+
+
+/*
+ * Section contents. A section is only ever uniform when it uses 0 bits per index, as sections collapse once a single
+ * block state fills them.
+ */
+
+bool ChunkSection::IsUniform(BlockStateID* _blockState) const {
+    for (int attempt = 0;; attempt++) {
+        uint32_t startVersion = version.load(std::memory_order_acquire);
+
+        if ((startVersion & 1) == 0) {
+            const SectionStorage* readStorage = storage.load(std::memory_order_acquire);
+            bool uniform = readStorage->bitsPerIndex == 0;
+            auto& entry = const_cast<BlockStateID&>(readStorage->palette[0]);
+            BlockStateID blockState = std::atomic_ref<BlockStateID>(entry).load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == startVersion) {
+                if (uniform && _blockState != nullptr) *_blockState = blockState;
+                return uniform;
+            }
+        }
+
+        ReadBackoff(attempt);
+    }
+}
+
+bool ChunkSection::ContainsBlockState(BlockStateID _blockState) {
+    std::unique_lock lockGuard(sectionLock);
+
+    SectionStorage* currentStorage = storage.load(std::memory_order_relaxed);
+    for (int p = 0; p < currentStorage->paletteSize; p++) {
+        if (currentStorage->palette[p] == _blockState) return currentStorage->paletteCounts[p] > 0;
+    }
+
+    return false;
+}
+
+
+
+/*
+ * Approximate number of bytes used by the section, including the storages kept for reuse
+ */
+
+size_t ChunkSection::GetMemoryUsage() {
+    std::unique_lock lockGuard(sectionLock);
+
+    size_t bytes = sizeof(ChunkSection);
+    for (const auto& sectionStorage : storages) {
+        bytes += sizeof(SectionStorage);
+        bytes += sectionStorage->palette.capacity() * sizeof(BlockStateID);
+        bytes += sectionStorage->paletteCounts.capacity() * sizeof(int);
+        bytes += sectionStorage->packedIndexes.capacity() * sizeof(uint64_t);
+    }
+    bytes += uniqueAttributes.capacity() * sizeof(std::pair<uint16_t, BlockAttributes>);
+
+    return bytes;
+}
@@ -0,0 +1,125 @@
+#ifndef UNTITLED7_CHUNKSECTION_H
+#define UNTITLED7_CHUNKSECTION_H
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "../../Blocks/BlockRegistry.h"
+#include "../WorldGenConsts.h"
+
+/*
+ * The palette and packed palette indexes of a section for a single number of bits per index. Storages are only
+ * released when their section is destroyed, so a reader may safely finish reading a storage which has been replaced.
+ */
+
+struct SectionStorage {
+    const int bitsPerIndex;
+
+    // The palette is sized to the most entries bitsPerIndex can address, so it never reallocates
+    std::vector<BlockStateID> palette;
+    std::vector<uint64_t> packedIndexes;
+
+    // Only accessed by writers
+    std::vector<int> paletteCounts;
+    int paletteSize = 0;
+
+    explicit SectionStorage(int _bitsPerIndex);
+
+    [[nodiscard]] int GetPaletteIndex(int _blockIndex) const;
+    void SetPaletteIndex(int _blockIndex, int _paletteIndex);
+    void SetPaletteEntry(int _paletteIndex, BlockStateID _blockState);
+    void Clear();
+};
+
+/*
+ * A section compressed for the chunk cache (see ChunkCache). Holds the block states used by the section, and runs of
+ * consecutive blocks (in block index order) using the same one of them, each stored as the palette index in the upper
+ * 16 bits and the run length - 1 in the lower 16 bits. A uniform section is a single run.
+ */
+
+struct CompressedSection {
+    std::vector<BlockStateID> palette {};
+    std::vector<uint32_t> runs {};
+    std::vector<std::pair<uint16_t, BlockAttributes>> uniqueAttributes {};
+};
+
+/*
+ * A 16x16x16 (sectionVolume) cube of blocks within a chunk. Rather than storing a BlockStateID for every position, the
+ * section stores a small palette of the block states which appear within it, and a bit-packed array of indexes into
+ * that palette. The number of bits used per index widens automatically (0, 1, 2, 4, 8, 16) as new states are added,
+ * so a section of only air requires no index storage at all. The number of blocks using each palette entry is also
+ * tracked, so that sections which are entirely air, or entirely one block state, can be skipped by meshing and
+ * generation. Sections which become entirely one block state collapse back to 0 bits per index.
+ *
+ * Block states are read without locking. Writers hold the section lock and keep the version odd whilst writing, and
+ * readers retry if the version changed during their read (a seqlock). Changing the number of bits per index swaps in a
+ * different SectionStorage rather than reallocating the one a reader may be using. Replaced storages are kept until the
+ * section is reset for a recycled chunk, which no reader can still see, leaving only the air storage and one spare.
+ *
+ * Unique block attributes are held in a sparse side table sorted by block index, which only contains the blocks whose
+ * attributes differ from a default constructed BlockAttributes.
+ */
+
+class ChunkSection {
+    private:
+        // The current storage, and the storages created by the section since it was last reset. Storages are reused when
+        // the section returns to the same bitsPerIndex, so there is at most one storage per bitsPerIndex. A reader may
+        // still be using a replaced storage, so they are only released by Reset
+        std::atomic<SectionStorage*> storage {};
+        std::vector<std::unique_ptr<SectionStorage>> storages {};
+        std::atomic<int> nonAirBlocks = 0;
+
+        // Odd whilst a write is in progress
+        std::atomic<uint32_t> version = 0;
+
+        // Unique block attributes, sorted by block index
+        std::vector<std::pair<uint16_t, BlockAttributes>> uniqueAttributes {};
+        std::atomic<int> nUniqueAttributes = 0;
+
+        std::mutex sectionLock;
+
+        // Storage management
+        SectionStorage* GetUnusedStorage(int _bitsPerIndex);
+        int GetOrAddPaletteEntry(BlockStateID _blockState);
+        void WidenIndexes(int _bitsPerIndex);
+        void CollapseToUniform(int _paletteIndex);
+
+        // Unique attribute management
+        [[nodiscard]] std::vector<std::pair<uint16_t, BlockAttributes>>::iterator FindUniqueAttributes(int _blockIndex);
+
+    public:
+        ChunkSection();
+
+        // Position within the section, values assumed to be within 0 - 15
+        [[nodiscard]] static int GetBlockIndex(int _x, int _y, int _z) {
+            return _x + _z * sectionSize + _y * chunkArea;
+        }
+
+        // Block getting / setting
+        [[nodiscard]] BlockStateID GetBlockState(int _blockIndex) const;
+        void SetBlockState(int _blockIndex, BlockStateID _blockState);
+        [[nodiscard]] bool GetUniqueAttributes(int _blockIndex, BlockAttributes* _attributes);
+        void SetUniqueAttributes(int _blockIndex, const BlockAttributes& _attributes);
+        void ClearUniqueAttributes(int _blockIndex);
+        void CopyUniqueAttributes(std::vector<std::pair<uint16_t, BlockAttributes>>* _attributes);
+        void Reset();
+
+        // Compression for the chunk cache
+        void Compress(CompressedSection* _compressed);
+        void Decompress(const CompressedSection& _compressed);
+
+        // Section contents
+        [[nodiscard]] bool IsEmpty() const { return nonAirBlocks.load(std::memory_order_relaxed) == 0; }
+        [[nodiscard]] bool IsUniform(BlockStateID* _blockState = nullptr) const;
+        [[nodiscard]] bool ContainsBlockState(BlockStateID _blockState);
+
+        // Debug
+        [[nodiscard]] size_t GetMemoryUsage();
+};
+
+#endif //UNTITLED7_CHUNKSECTION_H
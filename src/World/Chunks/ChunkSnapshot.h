@@ -0,0 +1,90 @@
+#ifndef UNTITLED7_CHUNKSNAPSHOT_H
+#define UNTITLED7_CHUNKSNAPSHOT_H
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+#include "../../Blocks/BlockRegistry.h"
+#include "../WorldGenConsts.h"
+
+/*
+ * A copy of the block states of a chunk, plus a 1 block apron from the adjacent chunks and above / below the world, in
+ * one contiguous 18x(chunkHeight + 2)x18 buffer. Positions are chunk block positions, from -1 to chunkSize (or
+ * chunkHeight) inclusive. Positions in unloaded chunks or outside the world are air. Created by Chunk::CreateSnapshot
+ * so meshing can read neighbouring blocks without accessing the world or other chunks.
+ *
+ * Along with the block states, the snapshot holds the unique attributes of the chunk's copied sections, and which of
+ * the copied sections of the chunk and its neighbours were empty or entirely one opaque block state.
+ */
+
+struct ChunkSnapshot {
+    static const int paddedSize = chunkSize + 2;
+    static const int paddedHeight = chunkHeight + 2;
+    static const int paddedVolume = paddedSize * paddedSize * paddedHeight;
+
+    std::vector<BlockStateID> blockStates = std::vector<BlockStateID>(paddedVolume, airState);
+
+    // Unique attributes of the chunk's copied sections, sorted by block index (see ChunkSection)
+    std::array<std::vector<std::pair<uint16_t, BlockAttributes>>, chunkSections> sectionAttributes {};
+
+    // Bit s is set if section s was entirely air, or entirely one opaque block state. Opaque sections are held for the
+    // chunk and the 8 surrounding chunks (see GetNeighbourIndex)
+    uint32_t emptySections = 0;
+    std::array<uint32_t, 9> opaqueSections {};
+
+    // The terrain version of the chunk when the copy began. If the chunk's version has since changed, anything built
+    // from the snapshot is out of date
+    uint32_t terrainVersion = 0;
+
+    [[nodiscard]] static int GetIndex(int _x, int _y, int _z) {
+        return (_x + 1) + (_z + 1) * paddedSize + (_y + 1) * paddedSize * paddedSize;
+    }
+
+    [[nodiscard]] BlockStateID GetBlockState(int _x, int _y, int _z) const {
+        return blockStates[GetIndex(_x, _y, _z)];
+    }
+
+    [[nodiscard]] BlockStateID GetBlockState(const glm::vec3& _blockPos) const {
+        return blockStates[GetIndex((int)_blockPos.x, (int)_blockPos.y, (int)_blockPos.z)];
+    }
+
+    // Attributes of a block of the chunk, within 0 - 15 (and a copied section)
+    [[nodiscard]] BlockAttributes GetAttributes(int _x, int _y, int _z) const {
+        const auto& attributes = sectionAttributes[_y / sectionSize];
+        int blockIndex = _x + _z * sectionSize + (_y % sectionSize) * chunkArea;
+
+        auto iter = std::lower_bound(attributes.begin(), attributes.end(), blockIndex,
+                                     [](const std::pair<uint16_t, BlockAttributes>& _entry, int _index) {
+                                         return _entry.first < _index;
+                                     });
+        if (iter == attributes.end() || iter->first != blockIndex) return {};
+        return iter->second;
+    }
+
+    // Section flags
+    [[nodiscard]] static int GetNeighbourIndex(int _dx, int _dz) { return (_dx + 1) + (_dz + 1) * 3; }
+    [[nodiscard]] bool SectionEmpty(int _section) const { return (emptySections >> _section) & 1; }
+    [[nodiscard]] bool SectionOpaque(int _section, int _dx = 0, int _dz = 0) const {
+        return (opaqueSections[GetNeighbourIndex(_dx, _dz)] >> _section) & 1;
+    }
+
+    /*
+     * Returns true if the section is entirely one opaque block type, and each adjacent section (including those of the
+     * adjacent chunks) is also entirely opaque. No faces within an enclosed section can be visible.
+     */
+
+    [[nodiscard]] bool SectionEnclosed(int _section) const {
+        // Faces on the top and bottom of the world are always visible
+        if (_section == 0 || _section == chunkSections - 1) return false;
+
+        return SectionOpaque(_section) && SectionOpaque(_section + 1) && SectionOpaque(_section - 1) &&
+               SectionOpaque(_section, 1, 0) && SectionOpaque(_section, -1, 0) &&
+               SectionOpaque(_section, 0, 1) && SectionOpaque(_section, 0, -1);
+    }
+};
+
+#endif //UNTITLED7_CHUNKSNAPSHOT_H
@@ -4,6 +4,8 @@
 
 #include "World.h"
 
+#include <algorithm>
+
 
 #include "../Blocks/CreateBlock.h"
 #include "Biomes/CreateBiome.h"
@@ -32,35 +34,56 @@ World::World() {
     if (uLocation < 0) printf("location not found [worldAmbients.lightingStrength]\n");
     else glUniform1f(uLocation, 1.0f);
 
-    uLocation = glGetUniformLocation(window.GetShader(), "worldAmbients.minFogDistance");
-    if (uLocation < 0) printf("location not found [worldAmbients.minFogDistance]\n");
-    else glUniform1f(uLocation, (renderRadius - 1) * chunkSize);
-
-    uLocation = glGetUniformLocation(window.GetShader(), "worldAmbients.maxFogDistance");
-    if (uLocation < 0) printf("location not found [worldAmbients.maxFogDistance]\n");
-    else glUniform1f(uLocation, renderRadius * chunkSize);
+    SetFogDistances();
 
     glEnable(GL_DEPTH_TEST);
 
-    // Set Mesher Retry Check
-    chunkMesherThread.SetRetryCheckFunction([&](const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos){
+    // Functions run by each kind of chunk job
+    chunkJobs.SetJobFunction(JOBKIND::CREATE, [this](const glm::ivec2& _index){ return CreateChunk(_index); });
+    chunkJobs.SetJobFunction(JOBKIND::GENERATE, [this](const glm::ivec2& _index){ return GenerateChunk(_index); });
+    chunkJobs.SetJobFunction(JOBKIND::MESH, [this](const glm::ivec2& _index){ return GenerateChunkMesh(_index); });
+    chunkJobs.SetJobFunction(JOBKIND::UNLOAD, [this](const glm::ivec2& _index){ return UnloadChunk(_index); });
+
+    // Chunks are only created and generated within the load region, or prefetched ahead of it
+    auto generationWanted = [&](const glm::ivec2& _chunkIndex){
         int diffX = std::abs(_chunkIndex.x - (int)loadingIndex.x);
         int diffZ = std::abs(_chunkIndex.y - (int)loadingIndex.y);
 
-        // chunk within load region returns true, permits retry
+        return (diffX + diffZ <= loadRadius + prefetchDistance);
+    };
+    chunkJobs.SetWantedCheckFunction(JOBKIND::CREATE, generationWanted);
+    chunkJobs.SetWantedCheckFunction(JOBKIND::GENERATE, generationWanted);
+
+    // Set Mesher Wanted Check
+    chunkJobs.SetWantedCheckFunction(JOBKIND::MESH, [&](const glm::ivec2& _chunkIndex){
+        int diffX = std::abs(_chunkIndex.x - (int)loadingIndex.x);
+        int diffZ = std::abs(_chunkIndex.y - (int)loadingIndex.y);
+
+        // chunk within mesh region returns true
         return (diffX + diffZ <= meshRadius);
     });
 
-    // Start threads
-    chunkBuilderThread.StartThread();
-    chunkMesherThread.StartThread();
-    chunkLoaderThread.StartThread();
+    // Start workers
+    chunkJobs.StartWorkers();
 }
 
 World::~World() {
-    chunkBuilderThread.EndThread();
-    chunkMesherThread.EndThread();
-    chunkLoaderThread.EndThread();
+    chunkJobs.EndWorkers();
+}
+
+/*
+ * Fog covers the last chunk of the render radius, so chunks fade out rather than popping in at the edge
+ */
+
+void World::SetFogDistances() const {
+    GLint uLocation;
+    uLocation = glGetUniformLocation(window.GetShader(), "worldAmbients.minFogDistance");
+    if (uLocation < 0) printf("location not found [worldAmbients.minFogDistance]\n");
+    else glUniform1f(uLocation, (renderRadius - 1) * chunkSize);
+
+    uLocation = glGetUniformLocation(window.GetShader(), "worldAmbients.maxFogDistance");
+    if (uLocation < 0) printf("location not found [worldAmbients.maxFogDistance]\n");
+    else glUniform1f(uLocation, renderRadius * chunkSize);
 }
 
 void World::Display() const {
@@ -107,7 +130,8 @@ void World::CheckCulling(const Camera &_camera) {
         }
     }
 
-    printf("DISPLAYING %d CHUNKS\n", displayingChunks);
+    printf("DISPLAYING %d CHUNKS | CHUNK CACHE %d HITS %d MISSES %zu KB\n", displayingChunks, chunkCache.GetHits(),
+           chunkCache.GetMisses(), chunkCache.GetUsedBytes() / 1024);
 }
 
 
@@ -220,68 +244,293 @@ void World::UpdateWorldTime(Uint64 _deltaTicks) {
  */
 
 void World::GenerateRequiredWorldRegion() {
-    using namespace std::placeholders;
-
     bool loadSquare = false;
+    chunkJobs.SetFocus(loadingIndex, {0, 0, 0});
+
+    ThreadAction originJob{loadingIndex};
 
     // Ensure chunks exist for loading region (and border) area
-    ThreadAction createChunkRegion{std::bind(&World::CreateChunk, this, _1, _2), loadingIndex};
-    chunkBuilderThread.AddPriorityActionRegion(createChunkRegion, loadRadius, loadSquare);
+    chunkJobs.AddJobRegion(JOBKIND::CREATE, originJob, loadRadius, loadSquare, true);
 
     // Generate the chunks within the loading region (and not border), this will be done after the chunks are created
-    ThreadAction generateChunk{std::bind(&World::GenerateChunk, this, _1, _2), loadingIndex};
-    chunkBuilderThread.AddActionRegion(generateChunk, loadRadius, loadSquare);
+    chunkJobs.AddJobRegion(JOBKIND::GENERATE, originJob, loadRadius, loadSquare);
 
     // Mesh the chunks within the loading region
-    ThreadAction createMesh{std::bind(&World::GenerateChunkMesh, this, _1, _2), loadingIndex};
-    chunkMesherThread.AddActionRegion(createMesh, meshRadius, loadSquare);
+    chunkJobs.AddJobRegion(JOBKIND::MESH, originJob, meshRadius, loadSquare);
 }
 
 
 
 /*
- * WORLD GENERATION
- * Creates chunk objects in the region around the player, adding their generation and
- * meshing functions into the threads
- * DONE FOR ENTIRE SQUARE AREA AS LOW PRIORITY ACTIONS
+ * WORLD STREAMING
+ * Moves the loading origin, queueing work only for the chunks whose membership of the loaded, meshed or unload regions
+ * changed. Chunks are unloaded beyond the unload radius rather than loadRadius, so moving back and forth across a chunk
+ * border finds the border chunks still loaded and generated, and queues nothing for them.
  */
 
-void World::GenerateLoadableWorldRegion() {
-    using namespace std::placeholders;
+void World::StreamWorldRegion(const glm::vec3& _origin) {
+    glm::ivec2 oldIndex = loadingIndex;
+    SetLoadingOrigin(_origin);
+    if (loadingIndex == oldIndex) return;
 
-    bool loadSquare = false;
+    std::vector<glm::ivec2> entering, meshing, leaving;
+    GetRegionDifference(loadingIndex, loadRadius, oldIndex, loadRadius, &entering);
+    GetRegionDifference(loadingIndex, meshRadius, oldIndex, meshRadius, &meshing);
+    GetRegionDifference(oldIndex, GetUnloadRadius(), loadingIndex, GetUnloadRadius(), &leaving);
 
-    // Ensure chunks exist for loading region (and border) area
-    ThreadAction createChunkRegion{std::bind(&World::CreateChunk, this, _1, _2), loadingIndex};
-    chunkBuilderThread.AddActionRegion(createChunkRegion, loadRadius, loadSquare);
+    QueueRegionChanges(entering, meshing, leaving);
+    UnloadPrefetchedChunks();
+}
 
-    // Generate the chunks within the loading region (and not border), this will be done after the chunks are created
-    ThreadAction generateChunk{std::bind(&World::GenerateChunk, this, _1, _2), loadingIndex};
-    chunkBuilderThread.AddActionRegion(generateChunk, loadRadius, loadSquare);
 
-    // Mesh the chunks within the loading region
-    ThreadAction createMesh{std::bind(&World::GenerateChunkMesh, this, _1, _2), loadingIndex};
-    chunkMesherThread.AddActionRegion(createMesh, meshRadius, loadSquare);
+
+/*
+ * Changes the view distances whilst running. The radii are limited so that meshRadius < loadRadius and renderRadius <=
+ * meshRadius. As when the loading origin moves, work is only queued for the chunks gained or lost by the change, and
+ * queued actions for chunks outside of the new radii fail once they are reached.
+ */
+
+void World::SetViewDistances(int _loadRadius, int _meshRadius, int _renderRadius) {
+    int newLoadRadius = std::clamp(_loadRadius, minLoadRadius, maxLoadRadius);
+    int newMeshRadius = std::clamp(_meshRadius, 1, newLoadRadius - 1);
+    int newRenderRadius = std::clamp(_renderRadius, 1, newMeshRadius);
+
+    int oldLoadRadius = loadRadius.exchange(newLoadRadius);
+    int oldMeshRadius = meshRadius.exchange(newMeshRadius);
+    renderRadius = newRenderRadius;
+
+    std::vector<glm::ivec2> entering, meshing, leaving;
+    GetRegionDifference(loadingIndex, newLoadRadius, loadingIndex, oldLoadRadius, &entering);
+    GetRegionDifference(loadingIndex, newMeshRadius, loadingIndex, oldMeshRadius, &meshing);
+    GetRegionDifference(loadingIndex, oldLoadRadius + unloadMargin, loadingIndex, newLoadRadius + unloadMargin, &leaving);
+
+    // Queued jobs for chunks outside of the new radii are dropped rather than run
+    chunkJobs.ExpireQueuedJobs();
+
+    QueueRegionChanges(entering, meshing, leaving);
+    UnloadPrefetchedChunks();
+    SetFogDistances();
+}
+
+
+
+/*
+ * Queues the generation, meshing and unloading of the chunks entering the load region, entering the mesh region and
+ * leaving the unload region respectively
+ */
+
+void World::QueueRegionChanges(const std::vector<glm::ivec2>& _entering, const std::vector<glm::ivec2>& _meshing,
+                               const std::vector<glm::ivec2>& _leaving) {
+    std::vector<ThreadAction> createActions, generateActions, meshActions, unloadActions;
+    {
+        auto chunks = ReadChunks();
+
+        // Chunks kept from an earlier visit to the region need no generation
+        for (const auto& chunkIndex : _entering) {
+            Chunk* chunk = BorrowChunkAtIndex(ChunkPos{chunkIndex.x, chunkIndex.y});
+            if (chunk != nullptr && chunk->Generated()) continue;
+
+            createActions.push_back({chunkIndex});
+            generateActions.push_back({chunkIndex});
+        }
+
+        // ... nor meshing, unless edited whilst outside of the mesh region
+        for (const auto& chunkIndex : _meshing) {
+            Chunk* chunk = BorrowChunkAtIndex(ChunkPos{chunkIndex.x, chunkIndex.y});
+            if (chunk != nullptr && !chunk->NeedsMeshUpdates()) continue;
+
+            meshActions.push_back({chunkIndex});
+        }
+
+        for (const auto& chunkIndex : _leaving) {
+            if (BorrowChunkAtIndex(ChunkPos{chunkIndex.x, chunkIndex.y}) == nullptr) continue;
+
+            unloadActions.push_back({chunkIndex});
+        }
+    }
+
+    // Meshes left waiting on generation are no longer wanted, including those of chunks which were never created
+    {
+        std::unique_lock lock(waitingMeshesLock);
+        for (const auto& chunkIndex : _leaving) waitingMeshes.erase(ChunkPos{chunkIndex.x, chunkIndex.y});
+    }
+
+    // Generation creates any of the chunk's neighbours not yet created, so that structures are built across its borders
+    // (see GenerateChunk)
+    chunkJobs.AddJobs(JOBKIND::CREATE, std::move(createActions));
+    chunkJobs.AddJobs(JOBKIND::GENERATE, std::move(generateActions));
+    chunkJobs.AddJobs(JOBKIND::MESH, std::move(meshActions));
+    chunkJobs.AddJobs(JOBKIND::UNLOAD, std::move(unloadActions), true);
+}
+
+
+
+/*
+ * WORLD PREFETCHING
+ * Predicts where the loading origin will be prefetchSeconds from now, from the player's velocity, and queues generation
+ * of the chunks that the load region would gain there. Chunks the player is facing towards are queued first, and at most
+ * prefetchBudget chunks are queued for each new prediction.
+ */
+
+void World::PrefetchWorldRegion(const glm::vec3& _velocity, const glm::vec3& _facingDirection) {
+    // Chunks travelled within prefetchSeconds, limited to prefetchDistance
+    glm::vec2 travel = glm::vec2{_velocity.x, _velocity.z} * prefetchSeconds / (float)chunkSize;
+    float travelDistance = std::abs(travel.x) + std::abs(travel.y);
+    if (travelDistance > prefetchDistance) travel *= prefetchDistance / travelDistance;
+
+    glm::ivec2 predictedIndex = loadingIndex + glm::ivec2{std::round(travel.x), std::round(travel.y)};
+    if (predictedIndex == loadingIndex || predictedIndex == prefetchIndex) return;
+    prefetchIndex = predictedIndex;
+    UnloadPrefetchedChunks();
+
+    std::vector<glm::ivec2> ahead;
+    GetRegionDifference(predictedIndex, loadRadius, loadingIndex, loadRadius, &ahead);
+
+    // Nearer chunks first, favouring those in the direction the player faces
+    glm::vec2 facing = {_facingDirection.x, _facingDirection.z};
+    if (glm::length(facing) > 0) facing = glm::normalize(facing);
+
+    auto prefetchOrder = [&](const glm::ivec2& _chunkIndex) {
+        glm::vec2 offset = _chunkIndex - loadingIndex;
+        return glm::length(offset) - glm::dot(offset, facing) * 0.5f;
+    };
+    std::sort(ahead.begin(), ahead.end(), [&](const glm::ivec2& _a, const glm::ivec2& _b) {
+        return prefetchOrder(_a) < prefetchOrder(_b);
+    });
+
+    std::vector<ThreadAction> createActions, generateActions;
+    {
+        auto chunks = ReadChunks();
+
+        for (const auto& chunkIndex : ahead) {
+            if (createActions.size() == prefetchBudget) break;
+
+            Chunk* chunk = BorrowChunkAtIndex(ChunkPos{chunkIndex.x, chunkIndex.y});
+            if (chunk != nullptr && chunk->Generated()) continue;
+
+            createActions.push_back({chunkIndex});
+            generateActions.push_back({chunkIndex});
+
+            std::unique_lock lock(prefetchedChunksLock);
+            prefetchedChunks.insert(ChunkPos{chunkIndex.x, chunkIndex.y});
+        }
+    }
+
+    chunkJobs.AddJobs(JOBKIND::CREATE, std::move(createActions));
+    chunkJobs.AddJobs(JOBKIND::GENERATE, std::move(generateActions));
+}
+
+
+
+/*
+ * Prefetched chunks are left to streaming once they are within the unload region, which unloads them as they leave it.
+ * Those still outside of it are unloaded once they are also beyond the unload radius of the latest prediction, as the
+ * player did not move towards them. Chunks not yet created stay tracked until they are, unless their creation fails for
+ * being too far from the loading origin.
+ */
+
+void World::UnloadPrefetchedChunks() {
+    std::vector<ThreadAction> unloadActions;
+
+    auto distance = [](const ChunkPos& _chunkPos, const glm::ivec2& _origin) {
+        return std::abs(_chunkPos.x - _origin.x) + std::abs(_chunkPos.z - _origin.y);
+    };
+
+    {
+        auto chunks = ReadChunks();
+        std::unique_lock lock(prefetchedChunksLock);
+        for (auto it = prefetchedChunks.begin(); it != prefetchedChunks.end();) {
+            if (distance(*it, loadingIndex) <= GetUnloadRadius()) {
+                it = prefetchedChunks.erase(it);
+                continue;
+            }
+
+            if (BorrowChunkAtIndex(*it) == nullptr) {
+                if (distance(*it, loadingIndex) > loadRadius + prefetchDistance) it = prefetchedChunks.erase(it);
+                else ++it;
+                continue;
+            }
+
+            if (distance(*it, prefetchIndex) <= GetUnloadRadius()) {
+                ++it;
+                continue;
+            }
+
+            unloadActions.push_back({glm::ivec2{it->x, it->z}});
+            it = prefetchedChunks.erase(it);
+        }
+    }
+
+    chunkJobs.AddJobs(JOBKIND::UNLOAD, std::move(unloadActions), true);
+}
+
+/*
+ * Whether a chunk may be created outside of its own creation job, which is only permitted where it is unloaded once no
+ * longer needed: within the unload region, or when prefetched
+ */
+
+bool World::ChunkCreationWanted(const glm::ivec2& _chunkIndex) const {
+    int diffX = std::abs(_chunkIndex.x - (int)loadingIndex.x);
+    int diffZ = std::abs(_chunkIndex.y - (int)loadingIndex.y);
+    if (diffX + diffZ <= GetUnloadRadius()) return true;
+
+    std::unique_lock lock(prefetchedChunksLock);
+    return prefetchedChunks.contains(ChunkPos{_chunkIndex.x, _chunkIndex.y});
+}
+
+
+
+/*
+ * Queued chunk jobs are run nearest first around the loading origin, favouring the chunks in the direction the player
+ * faces. Called as the player moves and turns.
+ */
+
+void World::FocusChunkJobs(const glm::vec3& _facingDirection) {
+    chunkJobs.SetFocus(loadingIndex, _facingDirection);
+}
+
+
+
+/*
+ * Outputs the chunk indexes within _radius (diamond) of _origin which are not within _excludedRadius of _excludedOrigin
+ */
+
+void World::GetRegionDifference(const glm::ivec2& _origin, int _radius, const glm::ivec2& _excludedOrigin,
+                                int _excludedRadius, std::vector<glm::ivec2>* _region) {
+    for (int x = -_radius; x < _radius + 1; x++) {
+        for (int z = -_radius; z < _radius + 1; z++) {
+            if (std::abs(x) + std::abs(z) > _radius) continue;
+
+            glm::ivec2 chunkIndex = _origin + glm::ivec2{x, z};
+            glm::ivec2 diff = glm::abs(chunkIndex - _excludedOrigin);
+            if (diff.x + diff.y <= _excludedRadius) continue;
+
+            _region->push_back(chunkIndex);
+        }
+    }
 }
 
 /*
  * Thread-Called function to retrieve chunk data for a given chunk index position.
  */
 
-THREAD_ACTION_RESULT World::CreateChunk(const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos) {
+THREAD_ACTION_RESULT World::CreateChunk(const glm::ivec2& _chunkIndex) {
     // Chunk object already exists, dont overwrite
     if (GetChunkAtIndex(_chunkIndex) != nullptr) {
         return ThreadAction::OK;
     }
 
-    // Get ChunkData and create the chunk
-    ChunkData chunkData = GenerateChunkData(_chunkIndex);
-    chunkData.biome = GenerateBiome(GetBiomeIDFromData(chunkData));
-
+    // A chunk which was unloaded recently is restored from the cache (see CreateChunkAtIndex), otherwise get ChunkData
+    // to generate it from
     glm::vec3 index{_chunkIndex.x, 0, _chunkIndex.y};
-    CreateChunkAtIndex(index, chunkData);
 
-    return ThreadAction::OK;
+    ChunkData chunkData;
+    if (!chunkCache.Contains(GetChunkPos(index))) {
+        chunkData = GenerateChunkData(_chunkIndex);
+        chunkData.biome = GenerateBiome(GetBiomeIDFromData(chunkData));
+    }
+
+    return CreateChunkAtIndex(index, chunkData);
 }
 
 
@@ -290,12 +539,12 @@ THREAD_ACTION_RESULT World::CreateChunk(const glm::ivec2& _chunkIndex, const glm
  * Obtains chunk data and generates a chunk (base terrain and decorative)
  */
 
-THREAD_ACTION_RESULT World::GenerateChunk(const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos) {
+THREAD_ACTION_RESULT World::GenerateChunk(const glm::ivec2& _chunkIndex) {
     auto st = SDL_GetTicks64();
 
     auto chunk = GetChunkAtIndex(_chunkIndex);
     if (chunk == nullptr) {
-        CreateChunk(_chunkIndex, {0, 0, 0});
+        if (CreateChunk(_chunkIndex) == ThreadAction::RETRY) return ThreadAction::RETRY;
         chunk = GetChunkAtIndex(_chunkIndex);
         if (chunk == nullptr) return ThreadAction::FAIL;
     }
@@ -304,11 +553,22 @@ THREAD_ACTION_RESULT World::GenerateChunk(const glm::ivec2& _chunkIndex, const g
     int diffX = std::abs(_chunkIndex.x - (int)loadingIndex.x);
     int diffZ = std::abs(_chunkIndex.y - (int)loadingIndex.y);
 
-    // chunk not within load region will not proceed to generate. returns fail.
-    if (diffX + diffZ > loadRadius) return ThreadAction::FAIL;
+    // chunk not within load region (or prefetched ahead of it) will not proceed to generate. returns fail.
+    if (diffX + diffZ > loadRadius + prefetchDistance) return ThreadAction::FAIL;
 
     // Generate the chunk's blocks
     if (!chunk->Generated()) {
+        // Structures are built across the chunk's borders, so the adjacent chunks which are to be loaded must exist first.
+        // Their creation jobs may be queued behind this job on other workers
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                glm::ivec2 adjIndex = _chunkIndex + glm::ivec2{dx, dz};
+                if ((dx == 0 && dz == 0) || !ChunkCreationWanted(adjIndex)) continue;
+
+                if (CreateChunk(adjIndex) == ThreadAction::RETRY) return ThreadAction::RETRY;
+            }
+        }
+
         chunk->GenerateChunk();
 
         auto et = SDL_GetTicks64();
@@ -318,16 +578,28 @@ THREAD_ACTION_RESULT World::GenerateChunk(const glm::ivec2& _chunkIndex, const g
         chunkAvgTicksTaken = chunkSumTicksTaken / nChunksCreated;
     }
 
+    // Another job may still be generating the chunk, in which case that job releases the waiting meshes
+    if (chunk->Generated()) ReleaseWaitingMeshes({_chunkIndex.x, _chunkIndex.y});
+
     return ThreadAction::OK;
 }
 
 
-THREAD_ACTION_RESULT World::GenerateChunkMesh(const glm::ivec2 &_chunkIndex, const glm::vec3& _blockPos) const {
+THREAD_ACTION_RESULT World::GenerateChunkMesh(const glm::ivec2 &_chunkIndex) const {
     auto chunk = GetChunkAtIndex(_chunkIndex);
 
-    if (chunk != nullptr && chunk->RegionGenerated() && chunk->NeedsMeshUpdates()) {
+    // The mesh job waits until the chunk and its adjacent chunks are generated, and is queued again by their generation
+    if (chunk == nullptr || !chunk->RegionGenerated()) {
+        if (!WaitForRegionGenerated({_chunkIndex.x, _chunkIndex.y})) return ThreadAction::OK;
+        chunk = GetChunkAtIndex(_chunkIndex);
+        if (chunk == nullptr) return ThreadAction::FAIL;
+    }
+
+    if (chunk->NeedsMeshUpdates()) {
         auto st = SDL_GetTicks64();
-        chunk->CreateChunkMeshes();
+
+        // The chunk was edited during meshing and the meshes were discarded, so mesh it again
+        if (!chunk->CreateChunkMeshes()) return ThreadAction::RETRY;
 
         auto et = SDL_GetTicks64();
 
@@ -337,44 +609,83 @@ THREAD_ACTION_RESULT World::GenerateChunkMesh(const glm::ivec2 &_chunkIndex, con
 
         return ThreadAction::OK;
     }
-    else if (chunk == nullptr || !chunk->RegionGenerated()) {
-        // TODO: can result in infinite recalling of function. apply limiter?
-        return ThreadAction::RETRY;
-    }
 
     return ThreadAction::FAIL;
 }
 
 
-void World::ManageLoadedChunks(const std::shared_ptr<Chunk>& _currentChunk, const std::shared_ptr<Chunk>& _newChunk) {
-    using namespace std::placeholders;
 
-    glm::vec2 oldChunkPos = {_currentChunk->GetIndex().x, _currentChunk->GetIndex().z};
+/*
+ * Marks the chunk's mesh as waiting on generation. The region is checked again after marking, as generation may have
+ * finished before the mark was seen (see ReleaseWaitingMeshes). Returns true if the region is now generated and the
+ * caller should mesh the chunk itself, or false if the mesh will be queued once the region is generated.
+ */
 
-    // hijack the blockPos intended for precision to store a second chunkPos instead
-    ThreadAction markUnloaded{std::bind(&World::CheckChunkLoaded, this, _1, _2),
-                              oldChunkPos, _newChunk->GetIndex()};
-    chunkLoaderThread.AddPriorityActionRegion(markUnloaded, loadRadius + 1, true);
+bool World::WaitForRegionGenerated(const ChunkPos& _chunkPos) const {
+    {
+        std::unique_lock lock(waitingMeshesLock);
+        waitingMeshes.insert(_chunkPos);
+    }
+
+    auto readGuard = ReadChunks();
+    Chunk* chunk = BorrowChunkAtIndex(_chunkPos);
+    if (chunk == nullptr || !chunk->RegionGenerated()) return false;
+
+    // Only one of this and ReleaseWaitingMeshes may remove the mark and mesh the chunk
+    std::unique_lock lock(waitingMeshesLock);
+    return waitingMeshes.erase(_chunkPos) == 1;
+}
+
+/*
+ * Called once a chunk has been generated. Queues the meshes of the chunk and its adjacent chunks which were waiting on
+ * it, if their regions are now fully generated.
+ */
+
+void World::ReleaseWaitingMeshes(const ChunkPos& _generatedPos) {
+    static const std::array<ChunkPos, 5> regionOffsets {{ {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1} }};
+
+    std::vector<ThreadAction> meshActions;
+    {
+        auto readGuard = ReadChunks();
+        std::unique_lock lock(waitingMeshesLock);
+        if (waitingMeshes.empty()) return;
+
+        for (const auto& offset : regionOffsets) {
+            ChunkPos chunkPos = _generatedPos + offset;
+            if (!waitingMeshes.contains(chunkPos)) continue;
+
+            Chunk* chunk = BorrowChunkAtIndex(chunkPos);
+            if (chunk == nullptr || !chunk->RegionGenerated()) continue;
+
+            waitingMeshes.erase(chunkPos);
+            meshActions.push_back({{(int)chunkPos.x, (int)chunkPos.z}});
+        }
+    }
+
+    chunkJobs.AddJobs(JOBKIND::MESH, std::move(meshActions), true);
 }
 
 
 
 /*
- * Enacts on all chunks in the current loaded region and checks if they continue to
- * be loaded in the new loaded region
+ * Unloads a chunk which left the unload region. The loading origin may have moved back towards the chunk since the
+ * unload was queued, in which case the chunk is kept
  */
 
-THREAD_ACTION_RESULT World::CheckChunkLoaded(const glm::ivec2 &_currentChunkPos, const glm::vec3 &_newChunkPos) {
-    glm::vec3 chunkIndex = {_currentChunkPos.x, 0, _currentChunkPos.y};
+THREAD_ACTION_RESULT World::UnloadChunk(const glm::ivec2 &_chunkIndex) {
+    int diffX = std::abs(_chunkIndex.x - (int)loadingIndex.x);
+    int diffZ = std::abs(_chunkIndex.y - (int)loadingIndex.y);
 
-    int diffX = std::abs(_currentChunkPos.x - (int)_newChunkPos.x);
-    int diffZ = std::abs(_currentChunkPos.y - (int)_newChunkPos.z);
+    // chunk within unload region, ignore
+    if (diffX + diffZ <= GetUnloadRadius()) return ThreadAction::OK;
 
-    // chunk within load region, ignore
-    if (diffX + diffZ <= loadRadius) return ThreadAction::OK;
+    // The chunk is queued to mesh again if it re-enters the mesh region
+    {
+        std::unique_lock lock(waitingMeshesLock);
+        waitingMeshes.erase({_chunkIndex.x, _chunkIndex.y});
+    }
 
-    // chunk is outside of the load radius so unload
-    return DestroyChunkAtIndex(chunkIndex);
+    return DestroyChunkAtIndex({_chunkIndex.x, 0, _chunkIndex.y});
 }
 
 
@@ -549,6 +860,8 @@ ChunkData World::GenerateChunkData(glm::vec2 _chunkPosition) {
  */
 
 Biome* World::GenerateBiome(Biome::ID _biomeID) {
+    std::unique_lock lock(biomeLock);
+
     // If the biome has been generated before then exit
     for (auto& uniqueBiome : uniqueBiomes) {
         if (uniqueBiome->GetBiomeID() == _biomeID) return uniqueBiome.get();
@@ -582,8 +895,7 @@ void World::BindChunks() const {
 
 
 std::shared_ptr<Chunk> World::GetChunkAtBlockPosition(glm::vec3 _blockPos) const {
-    glm::vec3 index = _blockPos / (float)chunkSize;
-    return GetChunkAtIndex(index);
+    return GetChunkAtIndex(GetChunkPos(GetBlockPos(_blockPos)));
 }
 
 std::shared_ptr<Chunk> World::GetChunkAtIndex(glm::vec2 _chunkIndex) const {
@@ -591,61 +903,217 @@ std::shared_ptr<Chunk> World::GetChunkAtIndex(glm::vec2 _chunkIndex) const {
 }
 
 std::shared_ptr<Chunk> World::GetChunkAtIndex(glm::vec3 _chunkIndex) const {
-    glm::vec3 index = _chunkIndex + glm::vec3{1000, 0, 1000}; // centre of the worlds chunks
+    return GetChunkAtIndex(GetChunkPos(_chunkIndex));
+}
 
-    if (index.x < 0 || index.x >= 2000) return nullptr;
-    if (index.z < 0 || index.z >= 2000) return nullptr;
+std::shared_ptr<Chunk> World::GetChunkAtIndex(const ChunkPos& _chunkPos) const {
+    glm::ivec2 slot = GetChunkSlot(_chunkPos);
 
     // permits multiple fetch requests for chunk
-    std::shared_lock lock(worldChunks[(int)index.x][(int)index.z].chunkLock);
-    std::shared_ptr<Chunk> chunkPtr = worldChunks[(int)index.x][(int)index.z].chunkPtr;
+    std::shared_lock lock(worldChunks[slot.x][slot.y].chunkLock);
+    std::shared_ptr<Chunk> chunkPtr = worldChunks[slot.x][slot.y].chunkPtr;
 
+    // The slot may still hold a chunk which shares the slot but has not yet been unloaded
+    if (chunkPtr == nullptr || chunkPtr->GetChunkPos() != _chunkPos) return nullptr;
     return chunkPtr;
 }
 
+/*
+ * Returns the chunk at the index without locking the slot or taking a reference to the chunk. The caller must hold a
+ * ChunkReadGuard (see ReadChunks) for as long as the returned chunk is used.
+ */
 
-THREAD_ACTION_RESULT World::DestroyChunkAtIndex(glm::vec3 _chunkIndex) {
-    glm::vec3 index = _chunkIndex + glm::vec3{1000, 0, 1000};
+Chunk* World::BorrowChunkAtIndex(glm::vec3 _chunkIndex) const {
+    return BorrowChunkAtIndex(GetChunkPos(_chunkIndex));
+}
+
+Chunk* World::BorrowChunkAtIndex(const ChunkPos& _chunkPos) const {
+    glm::ivec2 slot = GetChunkSlot(_chunkPos);
+
+    Chunk* chunk = worldChunks[slot.x][slot.y].borrowPtr.load(std::memory_order_acquire);
+    if (chunk == nullptr || chunk->GetChunkPos() != _chunkPos) return nullptr;
+    return chunk;
+}
+
+/*
+ * Borrows the chunk containing the block, and sets _localPos to the block's position within the chunk. The caller must
+ * hold a ChunkReadGuard (see ReadChunks) for as long as the returned chunk is used.
+ */
+
+Chunk* World::BorrowChunkAtBlockPos(const BlockPos& _blockPos, LocalBlockPos* _localPos) const {
+    if (_blockPos.y < 0 || _blockPos.y >= chunkHeight) return nullptr;
+
+    *_localPos = GetLocalBlockPos(_blockPos);
+    return BorrowChunkAtIndex(GetChunkPos(_blockPos));
+}
+
+/*
+ * Returns the block state at the world block position. Positions outside of the loaded world are air.
+ */
+
+BlockStateID World::GetBlockStateAtBlockPos(const BlockPos& _blockPos) const {
+    auto readGuard = ReadChunks();
 
-    if (index.x < 0 || index.x >= 2000) return ThreadAction::FAIL;
-    if (index.y < 0 || index.y >= 2000) return ThreadAction::FAIL;
+    LocalBlockPos localPos;
+    Chunk* chunk = BorrowChunkAtBlockPos(_blockPos, &localPos);
+    if (chunk == nullptr) return airState;
+
+    return chunk->GetChunkBlockState(localPos);
+}
+
+/*
+ * Returns the position of the chunk map slot used by the chunk index
+ */
+
+glm::ivec2 World::GetChunkSlot(const ChunkPos& _chunkPos) {
+    return {int(((_chunkPos.x % chunkMapSize) + chunkMapSize) % chunkMapSize),
+            int(((_chunkPos.z % chunkMapSize) + chunkMapSize) % chunkMapSize)};
+}
+
+
+THREAD_ACTION_RESULT World::DestroyChunkAtIndex(glm::vec3 _chunkIndex) {
+    ChunkPos chunkPos = GetChunkPos(_chunkIndex);
+    glm::ivec2 slot = GetChunkSlot(chunkPos);
 
     // only one thread may destroy the chunk, and only when no fetch requests are active
-    std::unique_lock lock(worldChunks[(int)index.x][(int)index.z].chunkLock, std::try_to_lock);
+    std::unique_lock lock(worldChunks[slot.x][slot.y].chunkLock, std::try_to_lock);
     if (!lock.owns_lock()) {
         // Chunk is busy right now so lock failed. Return it into the list
         return ThreadAction::RETRY;
     }
 
-    // owns lock, destroy chunk
-    worldChunks[(int)index.x][(int)index.z].chunkPtr.reset();
+    // owns lock, destroy chunk if the slot has not already been given to another chunk
+    std::shared_ptr<Chunk>& chunkPtr = worldChunks[slot.x][slot.y].chunkPtr;
+    if (chunkPtr == nullptr || chunkPtr->GetChunkPos() != chunkPos) return ThreadAction::OK;
+
+    // Borrowers may still be using the chunk, so it is only released once they are done
+    std::shared_ptr<Chunk> removedChunk = worldChunks[slot.x][slot.y].Take();
+    CacheChunk(removedChunk.get());
+    lock.unlock();
+
+    UnlinkChunk(removedChunk.get());
+    chunkEpochs.Retire(std::move(removedChunk));
     return ThreadAction::OK;
 }
 
 
 
 THREAD_ACTION_RESULT World::CreateChunkAtIndex(glm::vec3 _chunkIndex, ChunkData _chunkData) {
-    glm::vec2 index = {_chunkIndex.x + 1000, _chunkIndex.z + 1000};
-
-    if (index.x < 0 || index.x >= 2000) return ThreadAction::FAIL;
-    if (index.y < 0 || index.y >= 2000) return ThreadAction::FAIL;
+    ChunkPos chunkPos = GetChunkPos(_chunkIndex);
+    glm::ivec2 slot = GetChunkSlot(chunkPos);
 
     // only one thread may create the chunk, and only when no fetch requests are active
-    std::unique_lock lock(worldChunks[(int)index.x][(int)index.y].chunkLock, std::try_to_lock);
+    std::unique_lock lock(worldChunks[slot.x][slot.y].chunkLock, std::try_to_lock);
     if (!lock.owns_lock()) {
         // Chunk is busy right now so lock failed. Return it into the list
         return ThreadAction::RETRY;
     }
 
-    // owns lock, create chunk
-    worldChunks[(int)index.x][(int)index.y] = std::make_unique<Chunk>(_chunkIndex, _chunkData);
+    // another thread created the chunk first
+    std::shared_ptr<Chunk>& chunkPtr = worldChunks[slot.x][slot.y].chunkPtr;
+    if (chunkPtr != nullptr && chunkPtr->GetChunkPos() == chunkPos) return ThreadAction::OK;
+
+    // Cached terrain is only taken, and chunks only cached, whilst holding the slot's lock, so the terrain can not be lost
+    // to another thread creating the chunk at the same time
+    std::unique_ptr<CompressedChunk> cachedChunk = chunkCache.Take(chunkPos);
+    if (cachedChunk != nullptr) _chunkData.biome = cachedChunk->biome;
+
+    // The cached terrain was dropped since it was checked for, so the chunk data is generated by the retry
+    else if (_chunkData.biome == nullptr) return ThreadAction::RETRY;
+
+    // owns lock, create chunk (recycling an unloaded chunk where possible). Any chunk left in the slot is outside of the
+    // loaded region and replaced. Cached terrain is restored before the chunk is visible, so it is never generated
+    std::shared_ptr<Chunk> replacedChunk = worldChunks[slot.x][slot.y].Take();
+    if (replacedChunk != nullptr) CacheChunk(replacedChunk.get());
+
+    std::shared_ptr<Chunk> acquiredChunk = chunkPool.Acquire(_chunkIndex, _chunkData);
+    if (cachedChunk != nullptr) acquiredChunk->Decompress(*cachedChunk);
+
+    // Pinned before the chunk is visible, so that it is not retired and reused before it is linked
+    auto readGuard = ReadChunks();
+    worldChunks[slot.x][slot.y] = acquiredChunk;
+    Chunk* createdChunk = acquiredChunk.get();
+    lock.unlock();
+
+    if (replacedChunk != nullptr) UnlinkChunk(replacedChunk.get());
+    chunkEpochs.Retire(std::move(replacedChunk));
+    LinkChunk(createdChunk);
+
+    // Restored terrain, and the new links, may complete the regions of waiting meshes
+    ReleaseWaitingMeshes(chunkPos);
     return ThreadAction::OK;
 }
 
 
 
 
+/*
+ * Compresses a generated chunk which has been removed from the world into the chunk cache
+ */
+
+void World::CacheChunk(Chunk* _chunk) {
+    if (!_chunk->Generated()) return;
+
+    auto compressedChunk = std::make_unique<CompressedChunk>();
+    _chunk->Compress(compressedChunk.get());
+    chunkCache.Insert(_chunk->GetChunkPos(), std::move(compressedChunk));
+}
+
+
+
+/*
+ * Links a chunk which has just been added to the world with the adjacent chunks. Both the chunk and an adjacent chunk
+ * are in the world before they are linked, so if two adjacent chunks are added at once, at least one of them sees the
+ * other. The caller must keep the chunk pinned from adding it until it is linked, so that it cannot be reused meanwhile.
+ */
+
+void World::LinkChunk(Chunk* _chunk) const {
+    auto readGuard = ReadChunks();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            if (dx == 0 && dz == 0) continue;
+
+            ChunkPos adjPos = _chunk->GetChunkPos() + ChunkPos{dx, dz};
+            Chunk* adjChunk = BorrowChunkAtIndex(adjPos);
+            if (adjChunk == nullptr) continue;
+
+            _chunk->SetAdjacentChunk(dx, dz, adjChunk);
+            adjChunk->SetAdjacentChunk(-dx, -dz, _chunk);
+
+            // If the adjacent chunk was unloaded whilst linking, its unlinking may have missed this chunk
+            if (BorrowChunkAtIndex(adjPos) != adjChunk) _chunk->ClearAdjacentChunk(dx, dz, adjChunk);
+
+            // ... and likewise if this chunk was unloaded, so the adjacent chunk must not keep the link to it
+            if (BorrowChunkAtIndex(_chunk->GetChunkPos()) != _chunk) adjChunk->ClearAdjacentChunk(-dx, -dz, _chunk);
+        }
+    }
+}
+
+/*
+ * Removes the links to a chunk which has just been removed from the world, before it is retired
+ */
+
+void World::UnlinkChunk(Chunk* _chunk) const {
+    auto readGuard = ReadChunks();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            if (dx == 0 && dz == 0) continue;
+
+            Chunk* adjChunk = BorrowChunkAtIndex(_chunk->GetChunkPos() + ChunkPos{dx, dz});
+            if (adjChunk != nullptr) adjChunk->ClearAdjacentChunk(-dx, -dz, _chunk);
+        }
+    }
+}
+
+
+
 Biome* World::GetBiome(Biome::ID _biomeID) {
+    std::unique_lock lock(biomeLock);
+
     // Fetch biome
     for (auto& uniqueBiome : uniqueBiomes) {
         if (uniqueBiome->GetBiomeID() == _biomeID) return uniqueBiome.get();
@@ -655,23 +1123,3 @@ Biome* World::GetBiome(Biome::ID _biomeID) {
     uniqueBiomes.emplace_back(CreateBiome(_biomeID));
     return uniqueBiomes.back().get();
 }
-
-
-ChunkThreads* World::GetThread(THREAD _thread) {
-    switch (_thread) {
-        case THREAD::CHUNKBUILDING:
-            return &chunkBuilderThread;
-
-        case THREAD::CHUNKMESHING:
-            return &chunkMesherThread;
-
-        case THREAD::CHUNKLOADING:
-            return &chunkLoaderThread;
-
-        case THREAD::CHUNKLIGHTING:
-            return &chunkLighterThread;
-
-        default:
-            return nullptr;
-    }
-}
\ No newline at end of file
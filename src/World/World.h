@@ -10,33 +10,54 @@
 #include <thread>
 #include <utility>
 #include <random>
+#include <unordered_set>
 
 #include "../Player/Player.h"
 
 #include "Biomes/Biome.h"
 #include "Chunks/Chunk.h"
-#include "Chunks/ChunkThreads.h"
+#include "Chunks/ChunkPool.h"
+#include "Chunks/ChunkCache.h"
+#include "Chunks/ChunkEpochs.h"
+#include "Chunks/ChunkJobPool.h"
 
-enum class THREAD {
-        CHUNKBUILDING, CHUNKMESHING, CHUNKLOADING, CHUNKLIGHTING // ...
-};
+/*
+ * A slot of the chunk map. chunkPtr is only changed whilst holding chunkLock. borrowPtr mirrors chunkPtr so that chunks
+ * can be borrowed without locking (see ChunkEpochs).
+ */
 
 struct LockableChunkPtr {
     std::shared_ptr<Chunk> chunkPtr {};
+    std::atomic<Chunk*> borrowPtr {};
     mutable std::shared_mutex chunkLock;
 
     LockableChunkPtr& operator=(const std::shared_ptr<Chunk>& _chunkPtr) {
-        if (_chunkPtr != nullptr) chunkPtr = _chunkPtr;
+        if (_chunkPtr != nullptr) {
+            chunkPtr = _chunkPtr;
+            borrowPtr.store(chunkPtr.get(), std::memory_order_release);
+        }
         return *this;
     }
 
+    // Removes the chunk from the slot, returning it to be retired
+    std::shared_ptr<Chunk> Take() {
+        borrowPtr.store(nullptr, std::memory_order_release);
+        return std::move(chunkPtr);
+    }
+
     std::shared_ptr<Chunk> operator->() const {
         return chunkPtr;
     }
 };
 
+/*
+ * The loaded chunks are held in a ring of chunkMapSize x chunkMapSize slots, addressed by the chunk index modulo
+ * chunkMapSize. As the ring is wider than the loaded region, chunks sharing a slot are never loaded at the same time,
+ * and a slot's chunk is only returned if it is the chunk that was asked for.
+ */
+
 namespace WorldDataTypes {
-    typedef std::array<std::array<LockableChunkPtr, 2000>, 2000> chunkArray;
+    typedef std::array<std::array<LockableChunkPtr, chunkMapSize>, chunkMapSize> chunkArray;
 }
 
 class World {
@@ -50,20 +71,53 @@ class World {
         unsigned int worldTime = 7*60; // minutes
         unsigned int worldDays = 0;
 
-        // World Generation
+        // World Generation. The pool must be declared before the chunks it hands out so that it is destroyed after them
+        ChunkPool chunkPool {chunkPoolSize};
+        mutable ChunkEpochs chunkEpochs {};
+        ChunkCache chunkCache {chunkCacheBytes};
         WorldDataTypes::chunkArray worldChunks {};
         std::vector<std::unique_ptr<Biome>> uniqueBiomes {};
+        std::mutex biomeLock;
 
         int displayingChunks {};
 
-        // Threads
-        ChunkThreads chunkBuilderThread = ChunkThreads("BUILDER_THREAD");
-        ChunkThreads chunkMesherThread = ChunkThreads("MESHER_THREAD");
-        ChunkThreads chunkLoaderThread = ChunkThreads("LOADER_THREAD");
-        ChunkThreads chunkLighterThread = ChunkThreads("LIGHTING_THREAD");
+        // Workers creating, generating, meshing and unloading chunks
+        ChunkJobPool chunkJobs {};
+
+        // Chunks whose mesh jobs are waiting on the generation of the chunk and its adjacent chunks
+        mutable std::unordered_set<ChunkPos> waitingMeshes {};
+        mutable std::mutex waitingMeshesLock;
 
         glm::ivec2 loadingIndex {0, 0}; // centre
 
+        // View distances, read by the chunk threads. Changed whilst running through SetViewDistances
+        std::atomic<int> loadRadius = defaultLoadRadius;
+        std::atomic<int> meshRadius = defaultMeshRadius;
+        std::atomic<int> renderRadius = defaultRenderRadius;
+        glm::ivec2 prefetchIndex {0, 0}; // predicted centre last prefetched around
+
+        // Prefetched chunks outside of the unload region, which are unloaded once the prediction moves away from them
+        std::unordered_set<ChunkPos> prefetchedChunks {};
+        mutable std::mutex prefetchedChunksLock;
+
+        // Adjacent chunk links
+        void LinkChunk(Chunk* _chunk) const;
+        void UnlinkChunk(Chunk* _chunk) const;
+
+        // Keeps the terrain of an unloaded chunk for when it is next loaded
+        void CacheChunk(Chunk* _chunk);
+
+        // Mesh jobs released by chunk generation
+        [[nodiscard]] bool WaitForRegionGenerated(const ChunkPos& _chunkPos) const;
+        void ReleaseWaitingMeshes(const ChunkPos& _generatedPos);
+
+        // Streaming
+        void QueueRegionChanges(const std::vector<glm::ivec2>& _entering, const std::vector<glm::ivec2>& _meshing,
+                                const std::vector<glm::ivec2>& _leaving);
+        void UnloadPrefetchedChunks();
+        [[nodiscard]] bool ChunkCreationWanted(const glm::ivec2& _chunkIndex) const;
+        void SetFogDistances() const;
+
     public:
         World();
         ~World();
@@ -78,12 +132,11 @@ class World {
         void UpdateWorldTime(Uint64 _deltaTicks);
 
         // Thread Functions
-        THREAD_ACTION_RESULT CreateChunk(const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos);
-        THREAD_ACTION_RESULT GenerateChunk(const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos);
-        THREAD_ACTION_RESULT GenerateChunkMesh(const glm::ivec2& _chunkIndex, const glm::vec3& _blockPos) const;
+        THREAD_ACTION_RESULT CreateChunk(const glm::ivec2& _chunkIndex);
+        THREAD_ACTION_RESULT GenerateChunk(const glm::ivec2& _chunkIndex);
+        THREAD_ACTION_RESULT GenerateChunkMesh(const glm::ivec2& _chunkIndex) const;
 
-        void ManageLoadedChunks(const std::shared_ptr<Chunk>& _currentChunk, const std::shared_ptr<Chunk>& _newChunk);
-        THREAD_ACTION_RESULT CheckChunkLoaded(const glm::ivec2& _currentChunkPos, const glm::vec3& _newChunkPos);
+        THREAD_ACTION_RESULT UnloadChunk(const glm::ivec2& _chunkIndex);
 
         // ChunkData Generation functions
         static float GenerateBlockCavernosity(glm::vec2 _blockPos);
@@ -98,7 +151,18 @@ class World {
         //
         void SetLoadingOrigin(const glm::vec3& _origin);
         void GenerateRequiredWorldRegion();
-        void GenerateLoadableWorldRegion();
+        void StreamWorldRegion(const glm::vec3& _origin);
+        void PrefetchWorldRegion(const glm::vec3& _velocity, const glm::vec3& _facingDirection);
+        void FocusChunkJobs(const glm::vec3& _facingDirection);
+        static void GetRegionDifference(const glm::ivec2& _origin, int _radius, const glm::ivec2& _excludedOrigin,
+                                        int _excludedRadius, std::vector<glm::ivec2>* _region);
+
+        // View Distances
+        void SetViewDistances(int _loadRadius, int _meshRadius, int _renderRadius);
+        [[nodiscard]] int GetLoadRadius() const { return loadRadius; }
+        [[nodiscard]] int GetMeshRadius() const { return meshRadius; }
+        [[nodiscard]] int GetRenderRadius() const { return renderRadius; }
+        [[nodiscard]] int GetUnloadRadius() const { return loadRadius + unloadMargin; }
 
         void BindChunks() const;
 
@@ -106,12 +170,19 @@ class World {
         [[nodiscard]] std::shared_ptr<Chunk> GetChunkAtBlockPosition(glm::vec3 _blockPos) const;
         [[nodiscard]] std::shared_ptr<Chunk> GetChunkAtIndex(glm::vec2 _chunkIndex) const;
         [[nodiscard]] std::shared_ptr<Chunk> GetChunkAtIndex(glm::vec3 _chunkIndex) const;
+        [[nodiscard]] std::shared_ptr<Chunk> GetChunkAtIndex(const ChunkPos& _chunkPos) const;
+        [[nodiscard]] static glm::ivec2 GetChunkSlot(const ChunkPos& _chunkPos);
+        [[nodiscard]] ChunkReadGuard ReadChunks() const { return ChunkReadGuard(chunkEpochs); }
+        [[nodiscard]] Chunk* BorrowChunkAtIndex(glm::vec3 _chunkIndex) const;
+        [[nodiscard]] Chunk* BorrowChunkAtIndex(const ChunkPos& _chunkPos) const;
+        [[nodiscard]] Chunk* BorrowChunkAtBlockPos(const BlockPos& _blockPos, LocalBlockPos* _localPos) const;
+        [[nodiscard]] BlockStateID GetBlockStateAtBlockPos(const BlockPos& _blockPos) const;
         THREAD_ACTION_RESULT DestroyChunkAtIndex(glm::vec3 _chunkIndex);
         THREAD_ACTION_RESULT CreateChunkAtIndex(glm::vec3 _chunkIndex, ChunkData _chunkData);
 
 
         [[nodiscard]] Biome* GetBiome(Biome::ID _biomeID);
-        [[nodiscard]] ChunkThreads* GetThread(THREAD _thread);
+        [[nodiscard]] ChunkJobPool* GetJobPool() { return &chunkJobs; }
 };
 
 inline std::unique_ptr<World> world {};
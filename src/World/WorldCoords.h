@@ -0,0 +1,78 @@
+#ifndef UNTITLED7_WORLDCOORDS_H
+#define UNTITLED7_WORLDCOORDS_H
+
+#include <cstdint>
+#include <cmath>
+#include <functional>
+
+#include <glm/vec3.hpp>
+
+#include "WorldGenConsts.h"
+
+/*
+ * Integer world coordinates. Chunks are addressed by a 64-bit chunk position, and blocks by a 64-bit block position or
+ * by their offset within a chunk, so positions far from the origin are exact and converting between them is only
+ * shifts and masks. Float positions (as used by entities) are converted once with GetBlockPos / GetChunkPos.
+ */
+
+struct ChunkPos {
+    int64_t x = 0;
+    int64_t z = 0;
+
+    friend bool operator==(const ChunkPos& A, const ChunkPos& B) { return A.x == B.x && A.z == B.z; }
+    friend bool operator!=(const ChunkPos& A, const ChunkPos& B) { return !(A == B); }
+    friend ChunkPos operator+(const ChunkPos& A, const ChunkPos& B) { return {A.x + B.x, A.z + B.z}; }
+};
+
+// Required for maps keyed by chunk position
+template <>
+struct std::hash<ChunkPos> {
+    size_t operator()(const ChunkPos& A) const {
+        return std::hash<int64_t>()(A.x * 73856093) ^ std::hash<int64_t>()(A.z * 19349663);
+    }
+};
+
+struct BlockPos {
+    int64_t x = 0;
+    int y = 0;
+    int64_t z = 0;
+
+    friend bool operator==(const BlockPos& A, const BlockPos& B) { return A.x == B.x && A.y == B.y && A.z == B.z; }
+    friend bool operator!=(const BlockPos& A, const BlockPos& B) { return !(A == B); }
+};
+
+struct LocalBlockPos {
+    uint8_t x = 0;
+    uint16_t y = 0;
+    uint8_t z = 0;
+};
+
+// chunkSize is a power of 2, so flooring division and modulo of block positions are shifts and masks
+static const int chunkSizeBits = 4;
+static_assert((1 << chunkSizeBits) == chunkSize);
+
+/*
+ * Conversions between coordinate types
+ */
+
+inline ChunkPos GetChunkPos(const BlockPos& _blockPos) {
+    return {_blockPos.x >> chunkSizeBits, _blockPos.z >> chunkSizeBits};
+}
+
+inline ChunkPos GetChunkPos(const glm::vec3& _chunkIndex) {
+    return {(int64_t)std::floor(_chunkIndex.x), (int64_t)std::floor(_chunkIndex.z)};
+}
+
+inline LocalBlockPos GetLocalBlockPos(const BlockPos& _blockPos) {
+    return {uint8_t(_blockPos.x & (chunkSize - 1)), uint16_t(_blockPos.y), uint8_t(_blockPos.z & (chunkSize - 1))};
+}
+
+inline BlockPos GetBlockPos(const glm::vec3& _worldPos) {
+    return {(int64_t)std::floor(_worldPos.x), (int)std::floor(_worldPos.y), (int64_t)std::floor(_worldPos.z)};
+}
+
+inline BlockPos GetBlockPos(const ChunkPos& _chunkPos, const LocalBlockPos& _localPos) {
+    return {(_chunkPos.x << chunkSizeBits) + _localPos.x, _localPos.y, (_chunkPos.z << chunkSizeBits) + _localPos.z};
+}
+
+#endif //UNTITLED7_WORLDCOORDS_H
@@ -7,6 +7,7 @@
 
 #include <SDL.h>
 #include <random>
+#include <atomic>
 
 /*
  * WORLD VALUES
@@ -24,18 +25,38 @@ static const int BASETEMP = 15;
 static const int MAXTEMP = 40;
 
 
-// MAX SIZE OF THE WORLD AREA TO BE LOADED
-static const int loadRadius = 8; // minimum 2
-static const int meshRadius = loadRadius - 1;
-static const int renderRadius = meshRadius; // at maximum = meshRadius
-static const int worldSize = (1 + loadRadius*2) + 2; // + 2 for border chunks to permit structure generation at world chunk borders
+// SIZE OF THE WORLD AREA TO BE LOADED. The radii in use are changed at runtime (see World::SetViewDistances)
+static const int defaultLoadRadius = 8;
+static const int defaultMeshRadius = defaultLoadRadius - 1;
+static const int defaultRenderRadius = defaultMeshRadius;
+static const int minLoadRadius = 2;
+static const int maxLoadRadius = 16;
+static const int unloadMargin = 1; // chunks are kept until this far beyond the load radius, so crossing back over a border is free
+static const int worldSize = (1 + maxLoadRadius*2) + 2; // + 2 for border chunks to permit structure generation at world chunk borders
 static const int worldArea = worldSize * worldSize;
+static const int chunkMapSize = worldSize * 2; // width of the ring of chunk slots, leaving room for lagging unloads
+static const int chunkPoolSize = ((1 + defaultLoadRadius*2) + 2) * 2; // unloaded chunks kept for reuse, roughly two border crossings worth
+static const size_t chunkCacheBytes = 64 * 1024 * 1024; // compressed terrain of unloaded chunks kept for reloading
+
+// PREFETCHING OF CHUNKS AHEAD OF THE PLAYER
+static const float prefetchSeconds = 2.0f; // how far ahead the player's movement is predicted
+static const int prefetchDistance = 4; // most chunks the predicted loading origin may lie from the current one
+static const int prefetchBudget = 24; // most chunks queued for generation by one prediction
+
+// THREADS READING CHUNKS (see ChunkEpochs and ChunkJobPool)
+static const int maxChunkReaders = 64; // reader slots, one for each thread which reads chunks
+static const int maxChunkWorkers = maxChunkReaders - 8; // job pool workers, leaving reader slots for the other threads
+
+// ORDERING OF CHUNK JOBS (see ChunkJobPool)
+static const float jobViewConeCos = 0.5f; // chunks within 60 degrees of the facing direction count as in view
+static const float jobOffViewPenalty = 4.0f; // chunks out of view are built after visible chunks this many chunks further away
+static const float jobFocusTurnCos = 0.966f; // the facing direction must turn by 15 degrees before the jobs are reordered
 
 // WORLD SEEDED GENERATION
 static long long int worldSeed = 1738350823;
 //static long long int worldSeed = time(nullptr);
-static std::mt19937 worldGenerationRandom(worldSeed);
-static std::mt19937 worldActionsRandom(worldSeed);
+static thread_local std::mt19937 worldGenerationRandom(worldSeed); // per thread, as chunks are generated in parallel
+static thread_local std::mt19937 worldActionsRandom(worldSeed);
 
 /*
  * CHUNK VALUES
@@ -47,16 +68,22 @@ static const int chunkHeight = 320;
 static const int chunkArea = chunkSize * chunkSize;
 static const int chunkProfile = chunkSize * chunkHeight;
 static const int chunkVolume = chunkArea * chunkHeight;
+static const int chunkColumnWords = (chunkHeight + 63) / 64; // 64-bit words per column of a block plane
+
+// SIZE OF THE SECTIONS WHICH DIVIDE A CHUNK VERTICALLY
+static const int sectionSize = chunkSize;
+static const int sectionVolume = chunkArea * sectionSize;
+static const int chunkSections = chunkHeight / sectionSize;
 
-// TRACKING TIME FOR CREATING CHUNKS
-inline int nChunksCreated;
-inline Uint64 chunkAvgTicksTaken = 0;
-inline Uint64 chunkSumTicksTaken = 0;
+// TRACKING TIME FOR CREATING CHUNKS (updated by every chunk job worker)
+inline std::atomic<int> nChunksCreated = 0;
+inline std::atomic<Uint64> chunkAvgTicksTaken = 0;
+inline std::atomic<Uint64> chunkSumTicksTaken = 0;
 
 // TRACKING TIME FOR CREATING BLOCK MESHES
-inline int nMeshesCreated;
-inline Uint64 meshAvgTicksTaken = 0;
-inline Uint64 meshSumTicksTaken = 0;
+inline std::atomic<int> nMeshesCreated = 0;
+inline std::atomic<Uint64> meshAvgTicksTaken = 0;
+inline std::atomic<Uint64> meshSumTicksTaken = 0;
 
 
 /*
@@ -10,6 +10,7 @@
 #include "World/World.h"
 #include "World/Structures/LoadStructure.h"
 #include "Textures/TextureManager.h"
+#include "Blocks/BlockRegistry.h"
 
 #include "GlobalStates.h"
 
@@ -51,6 +52,9 @@ int main(int argc, char** argv){
     // Create the texture manager
     textureManager = std::make_unique<TextureManager>();
 
+    // Create the block registry
+    blockRegistry = std::make_unique<BlockRegistry>();
+
     /*
      *  WORLD CREATION
      */
@@ -89,17 +93,15 @@ int main(int argc, char** argv){
     bool escToggled = false;
 
     // Whilst the world is still loading the minimum required area, hold the user here
-    auto build = world->GetThread(THREAD::CHUNKBUILDING);
-    auto mesh = world->GetThread(THREAD::CHUNKMESHING);
+    auto jobs = world->GetJobPool();
 
-    while (build->HasActions() || mesh->HasActions()) {
+    while (jobs->HasJobs()) {
         // SDL EVENTS
         SDL_Event event;
         while (SDL_PollEvent(&event) != 0) {
             if (event.type == SDL_QUIT) {
                 running = false;
-                build->EndThread();
-                mesh->EndThread();
+                jobs->EndWorkers();
             }
         }
 